@@ -0,0 +1,1215 @@
+// created by pizpotli
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_batch.h"
+#include "s21_matrix_decomposition.h"
+#include "s21_matrix_expr.h"
+#include "s21_matrix_fixed.h"
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_lu.h"
+#include "s21_matrix_memory.h"
+#include "s21_matrix_oop.h"
+#include "s21_matrix_out_of_core.h"
+#include "s21_matrix_sparse.h"
+#include "s21_matrix_view.h"
+#include "s21_thread_pool.h"
+
+// Matrix buffers are the only aligned array allocations, counting them
+// gives the allocations per operation.
+static std::atomic<long> aligned_allocations{0};
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  aligned_allocations.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t alignment = static_cast<std::size_t>(align);
+  void* ptr = std::aligned_alloc(
+      alignment, (size + alignment - 1) / alignment * alignment);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+//********** STORAGE **********
+
+static void BM_Construct(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    S21Matrix m(n, n);
+    benchmark::DoNotOptimize(m.data());
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_Construct)->Arg(16)->Arg(256)->Arg(1000);
+
+static void BM_Copy(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix src(n, n);
+  for (auto _ : state) {
+    S21Matrix m(src);
+    benchmark::DoNotOptimize(m.data());
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_Copy)->Arg(16)->Arg(256)->Arg(1000);
+
+// copies of a copy-on-write matrix only take a reference
+static void BM_CopyShared(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix src(n, n);
+  src.SetCopyOnWrite(true);
+  for (auto _ : state) {
+    S21Matrix m(src);
+    benchmark::DoNotOptimize(std::as_const(m).data());
+  }
+}
+BENCHMARK(BM_CopyShared)->Arg(16)->Arg(256)->Arg(1000);
+
+// the deferred deep copy, on the first write to a shared copy
+static void BM_CopyDetach(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix src(n, n);
+  src.SetCopyOnWrite(true);
+  for (auto _ : state) {
+    S21Matrix m(src);
+    m(0, 0) = 1;
+    benchmark::DoNotOptimize(std::as_const(m).data());
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_CopyDetach)->Arg(16)->Arg(256)->Arg(1000);
+
+// move construction and move assignment, one of each per iteration
+static void BM_Move(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix src(n, n);
+  for (auto _ : state) {
+    S21Matrix m(std::move(src));
+    src = std::move(m);
+    benchmark::DoNotOptimize(src.data());
+  }
+}
+BENCHMARK(BM_Move)->Arg(16)->Arg(1000);
+
+// grows to 2n rows (or columns) and shrinks back; bytes are those copied
+static void BM_SetRows(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    m.SetRows(2 * n);
+    m.SetRows(n);
+    benchmark::DoNotOptimize(m.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+}
+BENCHMARK(BM_SetRows)->Arg(16)->Arg(256)->Arg(1000);
+
+static void BM_SetCols(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    m.SetCols(2 * n);
+    m.SetCols(n);
+    benchmark::DoNotOptimize(m.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+}
+BENCHMARK(BM_SetCols)->Arg(16)->Arg(256)->Arg(1000);
+
+static void BM_SweepOperator(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        sum += m(i, j);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_SweepOperator)->Arg(16)->Arg(256)->Arg(1000);
+
+static void BM_SweepData(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    const double* data = m.data();
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        sum += data[i * m.stride() + j];
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_SweepData)->Arg(16)->Arg(256)->Arg(1000);
+
+// reads through the const overload, which has no copy-on-write branch
+static void BM_SweepUnchecked(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const S21Matrix m(n, n);
+  for (auto _ : state) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        sum += m.UncheckedAt(i, j);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_SweepUnchecked)->Arg(16)->Arg(256)->Arg(1000);
+
+static void BM_SweepIterator(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    double sum = 0;
+    for (double x : m) sum += x;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_SweepIterator)->Arg(16)->Arg(256)->Arg(1000);
+
+// in-place update, which the compiler vectorizes once nothing can throw
+static void BM_ScaleOperator(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        m(i, j) = m(i, j) * 0.5 + 1;
+      }
+    }
+    benchmark::DoNotOptimize(m.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+}
+BENCHMARK(BM_ScaleOperator)->Arg(256)->Arg(1000);
+
+static void BM_ScaleRows(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix m(n, n);
+  for (auto _ : state) {
+    for (s21::MatrixRow<double> row : m.Rows()) {
+      for (double& x : row) x = x * 0.5 + 1;
+    }
+    benchmark::DoNotOptimize(m.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+}
+BENCHMARK(BM_ScaleRows)->Arg(256)->Arg(1000);
+
+//********** ELEMENT-WISE **********
+
+static void BM_SumMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * n * n * sizeof(double));
+}
+BENCHMARK(BM_SumMatrix)->Arg(64)->Arg(512)->Arg(2048);
+
+static void BM_SubMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * n * n * sizeof(double));
+}
+BENCHMARK(BM_SubMatrix)->Arg(64)->Arg(512)->Arg(2048);
+
+static void BM_MulNumber(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  for (auto _ : state) {
+    a.MulNumber(1.0);
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+}
+BENCHMARK(BM_MulNumber)->Arg(64)->Arg(512)->Arg(2048);
+
+static void BM_EqMatrix(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.EqMatrix(b));
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(double));
+}
+BENCHMARK(BM_EqMatrix)->Arg(64)->Arg(512)->Arg(2048);
+
+static void BM_ChainEager(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n), c(n, n), r(n, n);
+  for (auto _ : state) {
+    r = a + b * 2.0 - c;
+    benchmark::DoNotOptimize(r.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 4 * n * n * sizeof(double));
+}
+BENCHMARK(BM_ChainEager)->Arg(64)->Arg(512)->Arg(2048);
+
+static void BM_ChainFused(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n), c(n, n), r(n, n);
+  for (auto _ : state) {
+    r = s21::Lazy(a) + s21::Lazy(b) * 2.0 - c;
+    benchmark::DoNotOptimize(r.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 4 * n * n * sizeof(double));
+}
+BENCHMARK(BM_ChainFused)->Arg(64)->Arg(512)->Arg(2048);
+
+//********** MULMATRIX **********
+
+static S21Matrix FilledMatrix(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  double* data = m.data();
+  for (int i = 0; i < rows * cols; i++) {
+    data[i] = (i % 17) * 0.25 - 2.0;
+  }
+  return m;
+}
+
+// flops: floating-point operations of one iteration
+static void SetFlops(benchmark::State& state, double flops) {
+  state.counters["FLOP"] = benchmark::Counter(flops * state.iterations(),
+                                              benchmark::Counter::kIsRate);
+}
+
+static void SetGemmCounters(benchmark::State& state, int m, int n, int k) {
+  SetFlops(state, 2.0 * m * n * k);
+}
+
+// The i-j-k loop MulMatrix used before the blocked kernel.
+static void NaiveMul(const S21Matrix& a, const S21Matrix& b, S21Matrix& c) {
+  const int m = a.GetRows(), n = b.GetCols(), k = a.GetCols();
+  const double* pa = a.data();
+  const double* pb = b.data();
+  double* pc = c.data();
+  const int lda = a.stride(), ldb = b.stride(), ldc = c.stride();
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double res = 0;
+      for (int p = 0; p < k; p++) {
+        res += pa[i * lda + p] * pb[p * ldb + j];
+      }
+      pc[i * ldc + j] = res;
+    }
+  }
+}
+
+static void BM_MulNaive(benchmark::State& state) {
+  const int m = state.range(0), n = state.range(1), k = state.range(2);
+  S21Matrix a = FilledMatrix(m, k), b = FilledMatrix(k, n), c(m, n);
+  for (auto _ : state) {
+    NaiveMul(a, b, c);
+    benchmark::DoNotOptimize(c.data());
+  }
+  SetGemmCounters(state, m, n, k);
+}
+
+static void BM_MulMatrix(benchmark::State& state) {
+  const int m = state.range(0), n = state.range(1), k = state.range(2);
+  S21Matrix a = FilledMatrix(m, k), b = FilledMatrix(k, n);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(c.data());
+  }
+  SetGemmCounters(state, m, n, k);
+}
+
+static void GemmShapes(benchmark::internal::Benchmark* bench) {
+  for (int n : {64, 256, 512, 1024}) {
+    bench->Args({n, n, n});
+  }
+  bench->Args({8192, 32, 32});
+  bench->Args({8192, 64, 256});
+  bench->Args({64, 64, 8192});
+  bench->Unit(benchmark::kMillisecond);
+}
+BENCHMARK(BM_MulNaive)->Apply(GemmShapes);
+BENCHMARK(BM_MulMatrix)->Apply(GemmShapes);
+
+// counters as for the classic product, so FLOP/s above the kernel's own
+// rate is the saving of the skipped products
+static void BM_MulStrassen(benchmark::State& state) {
+  const int n = state.range(0);
+  S21Matrix a = FilledMatrix(n, n), b = FilledMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrixStrassen(b);
+    benchmark::DoNotOptimize(c.data());
+  }
+  SetGemmCounters(state, n, n, n);
+}
+BENCHMARK(BM_MulMatrix)
+    ->Args({2048, 2048, 2048})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MulStrassen)
+    ->Arg(512)
+    ->Arg(1024)
+    ->Arg(2048)
+    ->Unit(benchmark::kMillisecond);
+
+//********** DETERMINANT / INVERSE **********
+
+static S21Matrix WellConditioned(int n) {
+  S21Matrix m = FilledMatrix(n, n);
+  for (int i = 0; i < n; i++) {
+    m.data()[i * m.stride() + i] += 2.0 * n;
+  }
+  return m;
+}
+
+// LU is 2n^3/3 flops, the solve for the inverse another 4n^3/3
+static void BM_Determinant(benchmark::State& state) {
+  const double n = static_cast<double>(state.range(0));
+  S21Matrix a = WellConditioned(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Determinant());
+  }
+  state.SetComplexityN(state.range(0));
+  SetFlops(state, 2 * n * n * n / 3);
+}
+BENCHMARK(BM_Determinant)
+    ->RangeMultiplier(2)
+    ->Range(10, 1000)
+    ->Complexity(benchmark::oNCubed);
+
+static void BM_InverseMatrix(benchmark::State& state) {
+  S21Matrix a = WellConditioned(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.data());
+  }
+  state.SetComplexityN(state.range(0));
+  const double n = static_cast<double>(state.range(0));
+  SetFlops(state, 2 * n * n * n);
+}
+BENCHMARK(BM_InverseMatrix)
+    ->RangeMultiplier(2)
+    ->Range(10, 1000)
+    ->Complexity(benchmark::oNCubed)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_CalcComplements(benchmark::State& state) {
+  S21Matrix a = WellConditioned(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements.data());
+  }
+  const double n = static_cast<double>(state.range(0));
+  SetFlops(state, 2 * n * n * n);
+}
+BENCHMARK(BM_CalcComplements)
+    ->RangeMultiplier(2)
+    ->Range(10, 320)
+    ->Unit(benchmark::kMicrosecond);
+
+//********** SMALL FIXED-SIZE **********
+
+// one transform per iteration: time is ns/op
+
+template <int N>
+static void BM_SmallMulDynamic(benchmark::State& state) {
+  S21Matrix a = WellConditioned(N), b = WellConditioned(N);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+}
+BENCHMARK_TEMPLATE(BM_SmallMulDynamic, 3);
+BENCHMARK_TEMPLATE(BM_SmallMulDynamic, 4);
+
+template <int N>
+static void BM_SmallMulFixed(benchmark::State& state) {
+  S21FixedMatrix<N, N> a(WellConditioned(N)), b(WellConditioned(N));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    S21FixedMatrix<N, N> c = a * b;
+    benchmark::DoNotOptimize(c);
+  }
+}
+BENCHMARK_TEMPLATE(BM_SmallMulFixed, 3);
+BENCHMARK_TEMPLATE(BM_SmallMulFixed, 4);
+
+template <int N>
+static void BM_SmallInverseDynamic(benchmark::State& state) {
+  S21Matrix a = WellConditioned(N);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Determinant());
+    S21Matrix c = a.InverseMatrix();
+    benchmark::DoNotOptimize(c.data());
+  }
+}
+BENCHMARK_TEMPLATE(BM_SmallInverseDynamic, 3);
+BENCHMARK_TEMPLATE(BM_SmallInverseDynamic, 4);
+
+template <int N>
+static void BM_SmallInverseFixed(benchmark::State& state) {
+  S21FixedMatrix<N, N> a(WellConditioned(N));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(a.Determinant());
+    S21FixedMatrix<N, N> c = a.InverseMatrix();
+    benchmark::DoNotOptimize(c);
+  }
+}
+BENCHMARK_TEMPLATE(BM_SmallInverseFixed, 3);
+BENCHMARK_TEMPLATE(BM_SmallInverseFixed, 4);
+
+//********** MEMORY RESOURCES **********
+
+// A request handler: a few dozen same-sized temporaries per call.
+static double HandleRequest(const S21Matrix& a, const S21Matrix& b) {
+  double sum = 0;
+  for (int i = 0; i < 8; i++) {
+    S21Matrix r = (a * b + a.Transpose()) * 0.5 - b;
+    r += a * 2.0;
+    sum += r.Transpose().data()[i];
+  }
+  return sum;
+}
+
+enum class Resource { kDefault, kPool, kArena };
+
+// Latency percentiles over the individual requests, allocations per
+// request counted at operator new.
+static void BM_Requests(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const Resource resource = static_cast<Resource>(state.range(1));
+  S21Matrix a = FilledMatrix(n, n), b = FilledMatrix(n, n);
+  std::vector<double> latency;
+  const long allocations = aligned_allocations;
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    if (resource == Resource::kDefault) {
+      benchmark::DoNotOptimize(HandleRequest(a, b));
+    } else if (resource == Resource::kPool) {
+      S21MatrixResourceScope scope(&S21MatrixPool::Instance());
+      benchmark::DoNotOptimize(HandleRequest(a, b));
+    } else {
+      S21ScopedArena arena;
+      benchmark::DoNotOptimize(HandleRequest(a, b));
+    }
+    latency.push_back(std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - start)
+                          .count());
+  }
+  state.counters["allocs/op"] =
+      static_cast<double>(aligned_allocations - allocations) /
+      static_cast<double>(latency.size());
+  std::sort(latency.begin(), latency.end());
+  const std::pair<const char*, double> percentiles[] = {
+      {"p50_ns", 0.5}, {"p90_ns", 0.9}, {"p99_ns", 0.99}, {"p999_ns", 0.999}};
+  for (const auto& [name, rank] : percentiles) {
+    state.counters[name] = latency[static_cast<std::size_t>(
+        rank * static_cast<double>(latency.size() - 1))];
+  }
+  S21MatrixPool::Instance().Trim();
+}
+BENCHMARK(BM_Requests)
+    ->ArgNames({"n", "resource"})
+    ->ArgsProduct({{8, 32, 128}, {0, 1, 2}});
+
+//********** VIEWS **********
+
+// Trailing update A22 -= A21 * A12 of a blocked algorithm on an n x n
+// matrix with n/2 blocks, by copying the blocks out and back in ...
+static void BM_BlockUpdateCopy(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0)), h = n / 2;
+  S21Matrix a = FilledMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix a21(h, h), a12(h, h), a22(h, h);
+    for (int i = 0; i < h; i++) {
+      for (int j = 0; j < h; j++) {
+        a21(i, j) = a(h + i, j);
+        a12(i, j) = a(i, h + j);
+        a22(i, j) = a(h + i, h + j);
+      }
+    }
+    a22 -= a21 * a12;
+    for (int i = 0; i < h; i++) {
+      for (int j = 0; j < h; j++) a(h + i, h + j) = a22(i, j);
+    }
+    benchmark::DoNotOptimize(a.data());
+  }
+}
+BENCHMARK(BM_BlockUpdateCopy)->Arg(64)->Arg(256)->Arg(1024);
+
+// ... and in place through views.
+static void BM_BlockUpdateView(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0)), h = n / 2;
+  S21Matrix a = FilledMatrix(n, n);
+  S21MatrixView whole(a);
+  for (auto _ : state) {
+    whole.Block(h, h, h, h).MulAdd(whole.Block(h, 0, h, h),
+                                   whole.Block(0, h, h, h), -1.0);
+    benchmark::DoNotOptimize(a.data());
+  }
+}
+BENCHMARK(BM_BlockUpdateView)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_TransposedProductCopy(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = FilledMatrix(n, n), b = FilledMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = a.Transpose() * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+}
+BENCHMARK(BM_TransposedProductCopy)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_TransposedProductView(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = FilledMatrix(n, n), b = FilledMatrix(n, n);
+  for (auto _ : state) {
+    S21Matrix c = S21ConstMatrixView(a).TransposedView() * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+}
+BENCHMARK(BM_TransposedProductView)->Arg(64)->Arg(256)->Arg(1024);
+
+//********** TRANSPOSE **********
+
+static void SetTransposeBytes(benchmark::State& state, int rows, int cols) {
+  state.SetBytesProcessed(state.iterations() * 2 * sizeof(double) *
+                          static_cast<long>(rows) * cols);
+}
+
+static void BM_TransposeNaive(benchmark::State& state) {
+  const int rows = static_cast<int>(state.range(0));
+  const int cols = static_cast<int>(state.range(1));
+  S21Matrix a = FilledMatrix(rows, cols), t(cols, rows);
+  for (auto _ : state) {
+    for (int i = 0; i < cols; i++) {
+      double* dst = t.data() + i * t.stride();
+      for (int j = 0; j < rows; j++) dst[j] = a.data()[j * a.stride() + i];
+    }
+    benchmark::DoNotOptimize(t.data());
+  }
+  SetTransposeBytes(state, rows, cols);
+}
+BENCHMARK(BM_TransposeNaive)
+    ->Args({256, 256})
+    ->Args({1024, 1024})
+    ->Args({4096, 4096})
+    ->Args({1000, 3000});
+
+static void BM_Transpose(benchmark::State& state) {
+  const int rows = static_cast<int>(state.range(0));
+  const int cols = static_cast<int>(state.range(1));
+  S21Matrix a = FilledMatrix(rows, cols);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t.data());
+  }
+  SetTransposeBytes(state, rows, cols);
+}
+BENCHMARK(BM_Transpose)
+    ->Args({256, 256})
+    ->Args({1024, 1024})
+    ->Args({4096, 4096})
+    ->Args({1000, 3000});
+
+static void BM_TransposeInPlace(benchmark::State& state) {
+  const int rows = static_cast<int>(state.range(0));
+  const int cols = static_cast<int>(state.range(1));
+  S21Matrix a = FilledMatrix(rows, cols);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::DoNotOptimize(a.data());
+  }
+  SetTransposeBytes(state, rows, cols);
+}
+BENCHMARK(BM_TransposeInPlace)
+    ->Args({256, 256})
+    ->Args({1024, 1024})
+    ->Args({4096, 4096})
+    ->Args({1000, 3000});
+
+//********** PERSISTENCE **********
+
+static std::string BenchFile(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// The starting point: rebuilding a matrix from a text dump.
+static void BM_LoadText(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const std::string path = BenchFile("s21_bench.txt");
+  {
+    const S21Matrix a = FilledMatrix(n, n);
+    std::ofstream out(path);
+    out.precision(17);
+    for (int i = 0; i < n * n; i++) out << a.data()[i] << '\n';
+  }
+  for (auto _ : state) {
+    S21Matrix m(n, n);
+    std::ifstream in(path);
+    for (int i = 0; i < n * n; i++) in >> m.data()[i];
+    benchmark::DoNotOptimize(m.data());
+  }
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_LoadText)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+static void BM_Save(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const std::string path = BenchFile("s21_bench.bin");
+  const S21Matrix a = FilledMatrix(n, n);
+  for (auto _ : state) a.Save(path);
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_Save)->Arg(256)->Arg(1024)->Arg(4096)->Unit(
+    benchmark::kMillisecond);
+
+// Copy into an owning matrix, checksum verified (file in the page cache).
+static void BM_Load(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const std::string path = BenchFile("s21_bench.bin");
+  FilledMatrix(n, n).Save(path);
+  for (auto _ : state) {
+    S21Matrix m = S21Matrix::Load(path);
+    benchmark::DoNotOptimize(m.data());
+  }
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * n * n * sizeof(double));
+}
+BENCHMARK(BM_Load)->Arg(256)->Arg(1024)->Arg(4096)->Unit(
+    benchmark::kMillisecond);
+
+// Zero-copy: time until the matrix can be used, independent of its size.
+static void BM_MapFromFile(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  const std::string path = BenchFile("s21_bench.bin");
+  FilledMatrix(n, n).Save(path);
+  for (auto _ : state) {
+    S21MappedMatrix m = S21MappedMatrix::MapFromFile(path);
+    benchmark::DoNotOptimize(m(n - 1, n - 1));
+  }
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_MapFromFile)->Arg(256)->Arg(1024)->Arg(4096)->Unit(
+    benchmark::kMicrosecond);
+
+//********** OUT-OF-CORE **********
+
+// n x n operands on disk (in the page cache), result written back; the
+// in-memory variants load, compute and save.
+static void SaveOperands(int n) {
+  FilledMatrix(n, n).Save(BenchFile("s21_bench_a.bin"));
+  FilledMatrix(n, n).Save(BenchFile("s21_bench_b.bin"));
+}
+
+static void RemoveOperands() {
+  for (const char* name : {"s21_bench_a.bin", "s21_bench_b.bin",
+                           "s21_bench_c.bin"}) {
+    std::remove(BenchFile(name).c_str());
+  }
+}
+
+static void BM_InMemoryMul(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  SaveOperands(n);
+  for (auto _ : state) {
+    const S21Matrix a = S21Matrix::Load(BenchFile("s21_bench_a.bin"));
+    const S21Matrix b = S21Matrix::Load(BenchFile("s21_bench_b.bin"));
+    (a * b).Save(BenchFile("s21_bench_c.bin"));
+  }
+  RemoveOperands();
+}
+BENCHMARK(BM_InMemoryMul)->Arg(1024)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+// budget of a sixteenth of one operand
+static void BM_OutOfCoreMul(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  SaveOperands(n);
+  for (auto _ : state) {
+    s21::OutOfCoreMulMatrix(BenchFile("s21_bench_a.bin"),
+                            BenchFile("s21_bench_b.bin"),
+                            BenchFile("s21_bench_c.bin"),
+                            sizeof(double) * n * n / 16);
+  }
+  RemoveOperands();
+}
+BENCHMARK(BM_OutOfCoreMul)->Arg(1024)->Arg(2048)->Unit(
+    benchmark::kMillisecond);
+
+static void BM_InMemoryTranspose(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  SaveOperands(n);
+  for (auto _ : state) {
+    S21Matrix::Load(BenchFile("s21_bench_a.bin"))
+        .Transpose()
+        .Save(BenchFile("s21_bench_c.bin"));
+  }
+  RemoveOperands();
+}
+BENCHMARK(BM_InMemoryTranspose)->Arg(2048)->Arg(4096)->Unit(
+    benchmark::kMillisecond);
+
+static void BM_OutOfCoreTranspose(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  SaveOperands(n);
+  for (auto _ : state) {
+    s21::OutOfCoreTranspose(BenchFile("s21_bench_a.bin"),
+                            BenchFile("s21_bench_c.bin"),
+                            sizeof(double) * n * n / 16);
+  }
+  RemoveOperands();
+}
+BENCHMARK(BM_OutOfCoreTranspose)->Arg(2048)->Arg(4096)->Unit(
+    benchmark::kMillisecond);
+
+static void BM_InMemorySum(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  SaveOperands(n);
+  for (auto _ : state) {
+    const S21Matrix a = S21Matrix::Load(BenchFile("s21_bench_a.bin"));
+    const S21Matrix b = S21Matrix::Load(BenchFile("s21_bench_b.bin"));
+    (a + b).Save(BenchFile("s21_bench_c.bin"));
+  }
+  RemoveOperands();
+}
+BENCHMARK(BM_InMemorySum)->Arg(2048)->Arg(4096)->Unit(
+    benchmark::kMillisecond);
+
+static void BM_OutOfCoreSum(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  SaveOperands(n);
+  for (auto _ : state) {
+    s21::OutOfCoreSumMatrix(BenchFile("s21_bench_a.bin"),
+                            BenchFile("s21_bench_b.bin"),
+                            BenchFile("s21_bench_c.bin"),
+                            sizeof(double) * n * n / 16);
+  }
+  RemoveOperands();
+}
+BENCHMARK(BM_OutOfCoreSum)->Arg(2048)->Arg(4096)->Unit(
+    benchmark::kMillisecond);
+
+//********** SPARSE **********
+
+// n x n with density per_mille / 1000, non-zeros at pseudo-random places
+static S21Matrix SparseFilled(int n, int per_mille) {
+  S21Matrix m(n, n);
+  unsigned state = 12345;
+  for (int i = 0; i < n * n; i++) {
+    state = state * 1103515245u + 12345u;
+    if ((state >> 8) % 1000 < static_cast<unsigned>(per_mille)) {
+      m.data()[i] = (i % 17) * 0.25 - 2.0;
+    }
+  }
+  return m;
+}
+
+static void SetFootprint(benchmark::State& state, std::size_t bytes) {
+  state.counters["MiB"] = static_cast<double>(bytes) / (1 << 20);
+}
+
+// A (2000 x 2000, per mille argument) times a dense 2000 x 64 block
+static void BM_DenseTimesBlock(benchmark::State& state) {
+  const S21Matrix a = SparseFilled(2000, static_cast<int>(state.range(0)));
+  const S21Matrix x = FilledMatrix(2000, 64);
+  for (auto _ : state) {
+    S21Matrix y = a * x;
+    benchmark::DoNotOptimize(y.data());
+  }
+  SetFootprint(state, sizeof(double) * 2000 * 2000);
+}
+BENCHMARK(BM_DenseTimesBlock)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_SparseTimesBlock(benchmark::State& state) {
+  const S21SparseMatrix a(
+      SparseFilled(2000, static_cast<int>(state.range(0))));
+  const S21Matrix x = FilledMatrix(2000, 64);
+  for (auto _ : state) {
+    S21Matrix y = a * x;
+    benchmark::DoNotOptimize(y.data());
+  }
+  SetFootprint(state, a.GetMemoryUsage());
+}
+BENCHMARK(BM_SparseTimesBlock)->Arg(1)->Arg(10)->Unit(
+    benchmark::kMillisecond);
+
+// A * A for a 2000 x 2000 A
+static void BM_DenseSquare(benchmark::State& state) {
+  const S21Matrix a = SparseFilled(2000, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    S21Matrix y = a * a;
+    benchmark::DoNotOptimize(y.data());
+  }
+}
+BENCHMARK(BM_DenseSquare)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_SparseSquare(benchmark::State& state) {
+  const S21SparseMatrix a(
+      SparseFilled(2000, static_cast<int>(state.range(0))));
+  for (auto _ : state) {
+    S21SparseMatrix y = a * a;
+    benchmark::DoNotOptimize(y.values().data());
+  }
+}
+BENCHMARK(BM_SparseSquare)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_DenseAdd(benchmark::State& state) {
+  const S21Matrix a = SparseFilled(2000, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    S21Matrix y = a + a;
+    benchmark::DoNotOptimize(y.data());
+  }
+}
+BENCHMARK(BM_DenseAdd)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_SparseAdd(benchmark::State& state) {
+  const S21SparseMatrix a(
+      SparseFilled(2000, static_cast<int>(state.range(0))));
+  for (auto _ : state) {
+    S21SparseMatrix y = a + a;
+    benchmark::DoNotOptimize(y.values().data());
+  }
+}
+BENCHMARK(BM_SparseAdd)->Arg(1)->Arg(10)->Unit(benchmark::kMillisecond);
+
+static void BM_SparseTranspose(benchmark::State& state) {
+  const S21SparseMatrix a(
+      SparseFilled(2000, static_cast<int>(state.range(0))));
+  for (auto _ : state) {
+    S21SparseMatrix y = a.Transpose().ToFormat(S21SparseMatrix::Format::kCsr);
+    benchmark::DoNotOptimize(y.values().data());
+  }
+}
+BENCHMARK(BM_SparseTranspose)->Arg(10)->Unit(benchmark::kMillisecond);
+
+//********** ELEMENT TYPES **********
+
+// The same operations on double, float and bfloat16 storage; bytes are
+// those of the element type.
+template <typename T>
+static void BM_TypedSum(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21BasicMatrix<T> a(FilledMatrix(n, n)), b(FilledMatrix(n, n));
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * n * n * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_TypedSum, double)->Arg(512)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_TypedSum, float)->Arg(512)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_TypedSum, s21::BFloat16)->Arg(512)->Arg(2048);
+
+template <typename T>
+static void BM_TypedTranspose(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21BasicMatrix<T> a(FilledMatrix(n, n));
+  for (auto _ : state) {
+    S21BasicMatrix<T> t = a.Transpose();
+    benchmark::DoNotOptimize(t.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_TypedTranspose, double)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_TypedTranspose, float)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_TypedTranspose, s21::BFloat16)->Arg(2048);
+
+template <typename T>
+static void BM_TypedMul(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21BasicMatrix<T> a(FilledMatrix(n, n)), b(FilledMatrix(n, n));
+  for (auto _ : state) {
+    S21BasicMatrix<T> c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  SetGemmCounters(state, n, n, n);
+}
+BENCHMARK_TEMPLATE(BM_TypedMul, double)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TypedMul, float)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TypedMul, s21::BFloat16)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T>
+static void BM_TypedInverse(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix wide = FilledMatrix(n, n);
+  for (int i = 0; i < n; i++) wide(i, i) += n;
+  const S21BasicMatrix<T> a(wide);
+  for (auto _ : state) {
+    S21BasicMatrix<T> inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.data());
+  }
+}
+BENCHMARK_TEMPLATE(BM_TypedInverse, double)
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TypedInverse, float)
+    ->Arg(256)
+    ->Unit(benchmark::kMillisecond);
+
+//********** BATCH **********
+
+// 100000 small n x n matrices, one at a time and as one S21MatrixBatch;
+// items are matrices.
+constexpr int kBatchCount = 100000;
+
+static std::vector<S21Matrix> SmallMatrices(int n) {
+  std::vector<S21Matrix> matrices;
+  for (int i = 0; i < kBatchCount; i++) {
+    matrices.push_back(WellConditioned(n));
+    matrices.back()(i % n, 0) += i % 7;
+  }
+  return matrices;
+}
+
+static S21MatrixBatch SmallBatch(int n) {
+  const std::vector<S21Matrix> matrices = SmallMatrices(n);
+  S21MatrixBatch batch(kBatchCount, n, n);
+  for (int i = 0; i < kBatchCount; i++) batch.Set(i, matrices[i]);
+  return batch;
+}
+
+static void BM_LoopInverse(benchmark::State& state) {
+  const std::vector<S21Matrix> a = SmallMatrices(state.range(0));
+  for (auto _ : state) {
+    for (const S21Matrix& m : a) {
+      S21Matrix inverse = m.InverseMatrix();
+      benchmark::DoNotOptimize(inverse.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+}
+BENCHMARK(BM_LoopInverse)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchInverse(benchmark::State& state) {
+  const S21MatrixBatch a = SmallBatch(state.range(0));
+  for (auto _ : state) {
+    S21MatrixBatch inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+}
+BENCHMARK(BM_BatchInverse)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LoopDeterminant(benchmark::State& state) {
+  const std::vector<S21Matrix> a = SmallMatrices(state.range(0));
+  for (auto _ : state) {
+    for (const S21Matrix& m : a) benchmark::DoNotOptimize(m.Determinant());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+}
+BENCHMARK(BM_LoopDeterminant)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchDeterminant(benchmark::State& state) {
+  const S21MatrixBatch a = SmallBatch(state.range(0));
+  for (auto _ : state) {
+    std::vector<double> det = a.Determinant();
+    benchmark::DoNotOptimize(det.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+}
+BENCHMARK(BM_BatchDeterminant)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_LoopMul(benchmark::State& state) {
+  const std::vector<S21Matrix> a = SmallMatrices(state.range(0));
+  for (auto _ : state) {
+    for (const S21Matrix& m : a) {
+      S21Matrix product = m * m;
+      benchmark::DoNotOptimize(product.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+}
+BENCHMARK(BM_LoopMul)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchMul(benchmark::State& state) {
+  const S21MatrixBatch a = SmallBatch(state.range(0));
+  for (auto _ : state) {
+    S21MatrixBatch product = a * a;
+    benchmark::DoNotOptimize(product.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+}
+BENCHMARK(BM_BatchMul)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+//********** REPEATED SOLVE **********
+
+static void BM_SolveByInverse(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = WellConditioned(n), b = FilledMatrix(n, 1);
+  for (auto _ : state) {
+    S21Matrix x = a.InverseMatrix() * b;
+    benchmark::DoNotOptimize(x.data());
+  }
+}
+BENCHMARK(BM_SolveByInverse)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+static void BM_SolveByLU(benchmark::State& state) {
+  const int n = static_cast<int>(state.range(0));
+  S21Matrix a = WellConditioned(n), b = FilledMatrix(n, 1);
+  S21LU lu(a);
+  for (auto _ : state) {
+    S21Matrix x = lu.Solve(b);
+    benchmark::DoNotOptimize(x.data());
+  }
+}
+BENCHMARK(BM_SolveByLU)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+//********** THREAD SCALING **********
+
+static void ThreadCounts(benchmark::internal::Benchmark* bench) {
+  const int max = static_cast<int>(std::thread::hardware_concurrency());
+  for (int threads = 1; threads < max; threads *= 2) {
+    bench->Arg(threads);
+  }
+  bench->Arg(std::max(max, 1));
+  bench->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+static void BM_ScalingMulMatrix(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  S21Matrix a = FilledMatrix(1024, 1024), b = FilledMatrix(1024, 1024);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  SetGemmCounters(state, 1024, 1024, 1024);
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK(BM_ScalingMulMatrix)->Apply(ThreadCounts);
+
+static void BM_ScalingSumMatrix(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  S21Matrix a(4096, 4096), b(4096, 4096);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * 4096L * 4096 * 8);
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK(BM_ScalingSumMatrix)->Apply(ThreadCounts);
+
+static void BM_ScalingTranspose(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  S21Matrix a = FilledMatrix(4096, 4096);
+  for (auto _ : state) {
+    S21Matrix t = a.Transpose();
+    benchmark::DoNotOptimize(t.data());
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * 4096L * 4096 * 8);
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK(BM_ScalingTranspose)->Apply(ThreadCounts);
+
+static void BM_ScalingDeterminant(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  S21Matrix a = WellConditioned(1024);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Determinant());
+  }
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK(BM_ScalingDeterminant)->Apply(ThreadCounts);
+
+// Fork-join against task-graph execution of the same kernels: the
+// blocked LU waits for every trailing update before the next panel, the
+// tiled one overlaps them. Run on many cores to see the difference.
+
+template <int (*Factor)(double*, int, int, int*)>
+static void BM_ScalingLu(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  const int n = 2048;
+  const S21Matrix a = WellConditioned(n);
+  std::vector<int> perm(n);
+  for (auto _ : state) {
+    S21Matrix lu(a);
+    benchmark::DoNotOptimize(Factor(lu.data(), n, lu.stride(), perm.data()));
+  }
+  SetFlops(state, 2.0 * n * n * n / 3);
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK_TEMPLATE(BM_ScalingLu, s21::LuFactorBlocked<double>)
+    ->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_ScalingLu, s21::LuFactorTiled<double>)
+    ->Apply(ThreadCounts);
+
+template <void (*Multiply)(int, int, int, double, const double*, int, int,
+                           const double*, int, int, double*, int)>
+static void BM_ScalingGemm(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  const int n = 2048;
+  const S21Matrix a = FilledMatrix(n, n), b = FilledMatrix(n, n);
+  S21Matrix c(n, n);
+  for (auto _ : state) {
+    Multiply(n, n, n, 1.0, a.data(), a.stride(), 1, b.data(), b.stride(), 1,
+             c.data(), c.stride());
+    benchmark::DoNotOptimize(c.data());
+  }
+  SetGemmCounters(state, n, n, n);
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK_TEMPLATE(BM_ScalingGemm, s21::Gemm<double>)->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_ScalingGemm, s21::GemmTiled<double>)
+    ->Apply(ThreadCounts);
+
+static void BM_ScalingCholesky(benchmark::State& state) {
+  S21ThreadPool::Global().Resize(static_cast<int>(state.range(0)));
+  const int n = 2048;
+  S21Matrix spd(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) spd(i, j) = 1.0 / (1 + i + j);
+    spd(i, i) += n;
+  }
+  for (auto _ : state) {
+    S21Cholesky cholesky(spd);
+    benchmark::DoNotOptimize(&cholesky);
+  }
+  SetFlops(state, 1.0 * n * n * n / 3);
+  S21ThreadPool::Global().Resize(0);
+}
+BENCHMARK(BM_ScalingCholesky)->Apply(ThreadCounts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,380 @@
+// created by pizpotli
+#include "s21_matrix_batch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix_lu.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+constexpr int kLanes = S21MatrixBatch::kLanes;
+
+// Batches with less work than this many multiply-adds stay on the calling
+// thread.
+constexpr long kParallelWork = 1L << 16;
+
+// One element position across the matrices of a group; the compiler emits
+// whole-register arithmetic for these in every clone below.
+typedef double Lanes
+    __attribute__((vector_size(kLanes * sizeof(double)), may_alias));
+typedef long long LaneMask
+    __attribute__((vector_size(kLanes * sizeof(long long))));
+
+#if defined(__x86_64__) || defined(__i386__)
+// compiled for each instruction set, picked once at load time
+#define S21_BATCH_KERNEL \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define S21_BATCH_KERNEL
+#endif
+
+inline Lanes& At(double* group, int cols, int x, int y) {
+  return *reinterpret_cast<Lanes*>(group + (x * cols + y) * kLanes);
+}
+
+inline const Lanes& At(const double* group, int cols, int x, int y) {
+  return *reinterpret_cast<const Lanes*>(group + (x * cols + y) * kLanes);
+}
+
+// c (n x m) = a (n x k) * b (k x m)
+S21_BATCH_KERNEL void MulGroup(const double* a, const double* b, double* c,
+                               int n, int k, int m) {
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < m; j++) {
+      Lanes sum = {};
+      for (int p = 0; p < k; p++) {
+        sum += At(a, k, i, p) * At(b, m, p, j);
+      }
+      At(c, m, i, j) = sum;
+    }
+  }
+}
+
+// In-place LU with partial pivoting of every n x n matrix of the group, as
+// s21::LuFactor does for one: row i of PA is row perm[i * kLanes + lane]
+// of the original. Pivots differ between lanes, so only the row swaps are
+// done lane by lane. Returns the determinants in det and the smallest
+// pivot magnitudes in pivot, zero where the factorization broke down.
+S21_BATCH_KERNEL void FactorGroup(double* a, int n, int* perm, double* det,
+                                  double* pivot_min) {
+  const Lanes zero = {}, one = zero + 1;
+  Lanes sign = one, product = one;
+  Lanes smallest = zero + std::numeric_limits<double>::infinity();
+  for (int i = 0; i < n * kLanes; i++) {
+    perm[i] = i / kLanes;
+  }
+  for (int j = 0; j < n; j++) {
+    Lanes best = At(a, n, j, j);
+    best = best < zero ? -best : best;
+    LaneMask pivot = LaneMask{} + j;
+    for (int r = j + 1; r < n; r++) {
+      Lanes value = At(a, n, r, j);
+      value = value < zero ? -value : value;
+      const LaneMask larger = value > best;
+      best = larger ? value : best;
+      pivot = larger ? LaneMask{} + r : pivot;
+    }
+    for (int l = 0; l < kLanes; l++) {
+      const int r = static_cast<int>(pivot[l]);
+      if (r == j) continue;
+      for (int c = 0; c < n; c++) {
+        std::swap(a[(j * n + c) * kLanes + l], a[(r * n + c) * kLanes + l]);
+      }
+      std::swap(perm[j * kLanes + l], perm[r * kLanes + l]);
+      sign[l] = -sign[l];
+    }
+    const Lanes diag = At(a, n, j, j);
+    product *= diag;
+    const Lanes size = diag < zero ? -diag : diag;
+    smallest = size < smallest ? size : smallest;
+    // zero pivots (singular and padding matrices) eliminate nothing
+    const Lanes inverse = diag != zero ? one / diag : zero;
+    for (int r = j + 1; r < n; r++) {
+      const Lanes factor = At(a, n, r, j) * inverse;
+      At(a, n, r, j) = factor;
+      for (int c = j + 1; c < n; c++) {
+        At(a, n, r, c) -= factor * At(a, n, j, c);
+      }
+    }
+  }
+  *reinterpret_cast<Lanes*>(det) = sign * product;
+  *reinterpret_cast<Lanes*>(pivot_min) = smallest;
+}
+
+// x (n x m) = A^-1 b for the factors of FactorGroup; b == nullptr stands
+// for the identity.
+S21_BATCH_KERNEL void SolveGroup(const double* lu, const int* perm,
+                                 const double* b, double* x, int n, int m) {
+  for (int i = 0; i < n; i++) {
+    for (int c = 0; c < m; c++) {
+      for (int l = 0; l < kLanes; l++) {
+        const int row = perm[i * kLanes + l];
+        x[(i * m + c) * kLanes + l] =
+            b ? b[(row * m + c) * kLanes + l] : (row == c ? 1.0 : 0.0);
+      }
+    }
+  }
+  for (int i = 1; i < n; i++) {
+    for (int t = 0; t < i; t++) {
+      const Lanes factor = At(lu, n, i, t);
+      for (int c = 0; c < m; c++) {
+        At(x, m, i, c) -= factor * At(x, m, t, c);
+      }
+    }
+  }
+  const Lanes zero = {}, one = zero + 1;
+  for (int i = n - 1; i >= 0; i--) {
+    for (int t = i + 1; t < n; t++) {
+      const Lanes factor = At(lu, n, i, t);
+      for (int c = 0; c < m; c++) {
+        At(x, m, i, c) -= factor * At(x, m, t, c);
+      }
+    }
+    const Lanes diag = At(lu, n, i, i);
+    const Lanes inverse = diag != zero ? one / diag : zero;
+    for (int c = 0; c < m; c++) {
+      At(x, m, i, c) *= inverse;
+    }
+  }
+}
+
+// max column sum of |a| for every rows x cols matrix of the group
+S21_BATCH_KERNEL void Norm1Group(const double* a, int rows, int cols,
+                                 double* norm) {
+  const Lanes zero = {};
+  Lanes largest = zero;
+  for (int j = 0; j < cols; j++) {
+    Lanes sum = zero;
+    for (int i = 0; i < rows; i++) {
+      const Lanes value = At(a, cols, i, j);
+      sum += value < zero ? -value : value;
+    }
+    largest = sum > largest ? sum : largest;
+  }
+  *reinterpret_cast<Lanes*>(norm) = largest;
+}
+
+// Whether matrix lane of a group factored by FactorGroup is singular by
+// the Hager estimate that S21LU uses; norm is its ||A||_1. The factors of
+// the lane are gathered into lu and perm first.
+bool LaneSingular(const double* group_lu, const int* group_perm, int n,
+                  int lane, double norm, std::vector<double>& lu,
+                  std::vector<int>& perm) {
+  for (int i = 0; i < n; i++) {
+    perm[i] = group_perm[i * kLanes + lane];
+    for (int c = 0; c < n; c++) {
+      lu[i * n + c] = group_lu[(i * n + c) * kLanes + lane];
+    }
+  }
+  return s21::RcondSingular<double>(
+      s21::LuRcond(lu.data(), n, n, perm.data(), norm), n);
+}
+
+}  // namespace
+
+// KONSTRUCTORS
+
+S21MatrixBatch::S21MatrixBatch(int count, int rows, int cols)
+    : count_(count), rows_(rows), cols_(cols), groups_() {
+  if (count < 1 || rows < 1 || cols < 1) {
+    throw std::out_of_range("ERROR: incorrect matrix");
+  }
+  groups_ = S21Matrix(Groups(), rows * cols * kLanes);
+}
+
+// ARITHMETICS
+
+void S21MatrixBatch::MulMatrix(const S21MatrixBatch& other) {
+  *this = *this * other;
+}
+
+std::vector<double> S21MatrixBatch::Determinant() const {
+  CheckSquare();
+  std::vector<double> result(count_);
+  ForGroups(rows_ * rows_ * rows_, [&](int begin, int end) {
+    S21Matrix lu(1, rows_ * rows_ * kLanes), det(1, kLanes), pivot(1, kLanes);
+    std::vector<int> perm(rows_ * kLanes);
+    for (int g = begin; g < end; g++) {
+      std::memcpy(lu.data(), Group(g), sizeof(double) * lu.GetCols());
+      FactorGroup(lu.data(), rows_, perm.data(), det.data(), pivot.data());
+      const int lanes = std::min(kLanes, count_ - g * kLanes);
+      std::copy(det.data(), det.data() + lanes, &result[g * kLanes]);
+    }
+  });
+  return result;
+}
+
+S21MatrixBatch S21MatrixBatch::InverseMatrix() const {
+  CheckSquare();
+  S21MatrixBatch result(count_, rows_, cols_);
+  ForGroups(2 * rows_ * rows_ * rows_, [&](int begin, int end) {
+    S21Matrix lu(1, rows_ * rows_ * kLanes), det(1, kLanes), pivot(1, kLanes);
+    S21Matrix norm(1, kLanes), inverse_norm(1, kLanes);
+    std::vector<int> perm(rows_ * kLanes);
+    for (int g = begin; g < end; g++) {
+      std::memcpy(lu.data(), Group(g), sizeof(double) * lu.GetCols());
+      FactorGroup(lu.data(), rows_, perm.data(), det.data(), pivot.data());
+      SolveGroup(lu.data(), perm.data(), nullptr, result.Group(g), rows_,
+                 cols_);
+      // ||A||_1 ||A^-1||_1 from the computed inverse, as S21Matrix does
+      Norm1Group(Group(g), rows_, cols_, norm.data());
+      Norm1Group(result.Group(g), rows_, cols_, inverse_norm.data());
+      for (int l = 0; l < std::min(kLanes, count_ - g * kLanes); l++) {
+        if (!(pivot.data()[l] > 0) ||
+            s21::RcondSingular<double>(
+                1 / (norm.data()[l] * inverse_norm.data()[l]), rows_)) {
+          throw std::out_of_range(
+              "ERROR: calculation impossible: Determinant = 0");
+        }
+      }
+    }
+  });
+  return result;
+}
+
+S21MatrixBatch S21MatrixBatch::Solve(const S21MatrixBatch& rhs) const {
+  CheckSquare();
+  if (rhs.count_ != count_) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+  if (rhs.rows_ != rows_) {
+    throw std::out_of_range("ERROR: sides are not equal");
+  }
+  S21MatrixBatch result(count_, rows_, rhs.cols_);
+  ForGroups(rows_ * rows_ * (rows_ + rhs.cols_), [&](int begin, int end) {
+    S21Matrix lu(1, rows_ * rows_ * kLanes), det(1, kLanes), pivot(1, kLanes);
+    S21Matrix norm(1, kLanes);
+    std::vector<int> perm(rows_ * kLanes), lane_perm(rows_);
+    std::vector<double> lane_lu(rows_ * rows_);
+    for (int g = begin; g < end; g++) {
+      std::memcpy(lu.data(), Group(g), sizeof(double) * lu.GetCols());
+      FactorGroup(lu.data(), rows_, perm.data(), det.data(), pivot.data());
+      Norm1Group(Group(g), rows_, cols_, norm.data());
+      for (int l = 0; l < std::min(kLanes, count_ - g * kLanes); l++) {
+        if (LaneSingular(lu.data(), perm.data(), rows_, l, norm.data()[l],
+                         lane_lu, lane_perm)) {
+          throw std::out_of_range(
+              "ERROR: calculation impossible: Determinant = 0");
+        }
+      }
+      SolveGroup(lu.data(), perm.data(), rhs.Group(g), result.Group(g),
+                 rows_, rhs.cols_);
+    }
+  });
+  return result;
+}
+
+// OPERATORS
+
+S21MatrixBatch S21MatrixBatch::operator*(const S21MatrixBatch& other) const {
+  if (other.count_ != count_) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+  if (cols_ != other.rows_) {
+    throw std::out_of_range("ERROR: sides are not equal");
+  }
+  S21MatrixBatch result(count_, rows_, other.cols_);
+  ForGroups(rows_ * cols_ * other.cols_, [&](int begin, int end) {
+    for (int g = begin; g < end; g++) {
+      MulGroup(Group(g), other.Group(g), result.Group(g), rows_, cols_,
+               other.cols_);
+    }
+  });
+  return result;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator*=(const S21MatrixBatch& other) {
+  MulMatrix(other);
+  return *this;
+}
+
+double& S21MatrixBatch::operator()(const int index, const int x,
+                                   const int y) {
+  CheckIndex(index);
+  if (x >= rows_ || y >= cols_ || x < 0 || y < 0) {
+    throw std::out_of_range("ERROR: index outside matrix");
+  }
+  return Group(index / kLanes)[(x * cols_ + y) * kLanes + index % kLanes];
+}
+
+// ACCESSORS
+
+int S21MatrixBatch::GetCount() const noexcept { return count_; }
+
+int S21MatrixBatch::GetRows() const noexcept { return rows_; }
+
+int S21MatrixBatch::GetCols() const noexcept { return cols_; }
+
+S21Matrix S21MatrixBatch::Get(int index) const {
+  CheckIndex(index);
+  S21Matrix result(rows_, cols_);
+  const double* src = Group(index / kLanes) + index % kLanes;
+  for (int i = 0; i < rows_; i++) {
+    double* dst = result.data() + i * result.stride();
+    for (int j = 0; j < cols_; j++) {
+      dst[j] = src[(i * cols_ + j) * kLanes];
+    }
+  }
+  return result;
+}
+
+void S21MatrixBatch::Set(int index, const S21Matrix& matrix) {
+  CheckIndex(index);
+  if (matrix.GetRows() != rows_ || matrix.GetCols() != cols_) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+  double* dst = Group(index / kLanes) + index % kLanes;
+  for (int i = 0; i < rows_; i++) {
+    const double* src = matrix.data() + i * matrix.stride();
+    for (int j = 0; j < cols_; j++) {
+      dst[(i * cols_ + j) * kLanes] = src[j];
+    }
+  }
+}
+
+double* S21MatrixBatch::data() noexcept { return groups_.data(); }
+
+const double* S21MatrixBatch::data() const noexcept { return groups_.data(); }
+
+// HELP FUNCTIONS
+
+int S21MatrixBatch::Groups() const noexcept {
+  return (count_ + kLanes - 1) / kLanes;
+}
+
+double* S21MatrixBatch::Group(int group) noexcept {
+  return groups_.data() + static_cast<std::size_t>(group) * groups_.stride();
+}
+
+const double* S21MatrixBatch::Group(int group) const noexcept {
+  return groups_.data() + static_cast<std::size_t>(group) * groups_.stride();
+}
+
+void S21MatrixBatch::CheckIndex(int index) const {
+  if (index < 0 || index >= count_) {
+    throw std::out_of_range("ERROR: index outside batch");
+  }
+}
+
+void S21MatrixBatch::CheckSquare() const {
+  if (rows_ != cols_) {
+    throw std::out_of_range("ERROR: matrix is not square");
+  }
+}
+
+template <typename F>
+void S21MatrixBatch::ForGroups(int work_per_group, F&& body) const {
+  const long work = static_cast<long>(work_per_group) * kLanes;
+  if (work * Groups() < kParallelWork) {
+    body(0, Groups());
+  } else {
+    const int grain =
+        static_cast<int>(std::max(1L, kParallelWork / 4 / work));
+    S21ThreadPool::Global().ParallelFor(Groups(), grain, body);
+  }
+}
@@ -0,0 +1,75 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_BATCH_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_BATCH_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Many independent matrices of the same shape in one buffer. Matrices are
+// interleaved in groups of kLanes: element (x, y) of the matrices of a
+// group is kLanes consecutive doubles, so every operation works on a whole
+// group per instruction and groups are spread over the thread pool. Shapes
+// are checked once per call, not once per matrix; the last group is padded
+// with zero matrices that never show in results.
+class S21MatrixBatch {
+ public:
+  static constexpr int kLanes = 8;
+
+  // Konstructors
+
+  // count zero matrices of rows x cols
+  S21MatrixBatch(int count, int rows, int cols);
+
+  // Arithmetics
+
+  // every matrix times the matching one of other
+  void MulMatrix(const S21MatrixBatch& other);
+  std::vector<double> Determinant() const;
+  // throws std::out_of_range if any matrix is singular by the test of
+  // S21Matrix::InverseMatrix: ||A||_1 ||A^-1||_1 of the computed inverse
+  S21MatrixBatch InverseMatrix() const;
+  // X with matrix(i) * X(i) = rhs(i) for every i; rhs holds rows x k
+  // matrices. Throws std::out_of_range if any matrix is singular by the
+  // condition estimate of S21LU, taken matrix by matrix.
+  S21MatrixBatch Solve(const S21MatrixBatch& rhs) const;
+
+  // operators
+
+  S21MatrixBatch operator*(const S21MatrixBatch& other) const;
+  S21MatrixBatch& operator*=(const S21MatrixBatch& other);
+  // element (x, y) of matrix index
+  double& operator()(const int index, const int x, const int y);
+
+  // Accessors
+
+  int GetCount() const noexcept;
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+  S21Matrix Get(int index) const;
+  void Set(int index, const S21Matrix& matrix);
+
+  // Raw storage: element (x, y) of matrix i lives at
+  // data()[(i / kLanes * rows * cols + x * cols + y) * kLanes + i % kLanes]
+
+  double* data() noexcept;
+  const double* data() const noexcept;
+
+ private:
+  int count_, rows_, cols_;
+  // one row per group
+  S21Matrix groups_;
+
+  // help functions
+
+  int Groups() const noexcept;
+  double* Group(int group) noexcept;
+  const double* Group(int group) const noexcept;
+  void CheckIndex(int index) const;
+  void CheckSquare() const;
+  // body(begin, end) over ranges of groups, in parallel for large batches
+  template <typename F>
+  void ForGroups(int work_per_group, F&& body) const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_BATCH_H_
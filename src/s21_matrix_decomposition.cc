@@ -0,0 +1,390 @@
+// created by pizpotli
+#include "s21_matrix_decomposition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_lu.h"
+#include "s21_matrix_simd.h"
+#include "s21_task_graph.h"
+
+namespace {
+
+// Tiles of the Cholesky factorization.
+constexpr int kCholeskyTile = 128;
+
+// Row offset i * ld formed in std::ptrdiff_t: matrices of more than 2^31
+// elements overflow the int product.
+constexpr std::ptrdiff_t Offset(int i, int ld) noexcept {
+  return static_cast<std::ptrdiff_t>(i) * ld;
+}
+
+S21Matrix IdentityMatrix(int n) {
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) {
+    identity.data()[Offset(i, identity.stride()) + i] = 1;
+  }
+  return identity;
+}
+
+void CheckSquare(const S21Matrix& matrix) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::out_of_range("ERROR: matrix is not square");
+  }
+}
+
+void CheckRightSide(const S21Matrix& b, int rows) {
+  if (b.GetRows() != rows || b.GetCols() < 1) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+}
+
+// the lower part of the n x n block at a becomes its Cholesky factor
+void FactorDiagonal(double* a, int n, int lda) {
+  for (int i = 0; i < n; i++) {
+    double* ai = a + Offset(i, lda);
+    for (int j = 0; j <= i; j++) {
+      const double* aj = a + Offset(j, lda);
+      double sum = ai[j];
+      for (int t = 0; t < j; t++) {
+        sum -= ai[t] * aj[t];
+      }
+      if (i == j) {
+        if (!(sum > 0)) {
+          throw std::out_of_range("ERROR: matrix is not positive definite");
+        }
+        ai[i] = std::sqrt(sum);
+      } else {
+        ai[j] = sum / aj[j];
+      }
+    }
+  }
+}
+
+// rows x n block b = b L^-T, for the n x n factor l from FactorDiagonal
+void SolveLowerTransposed(const double* l, int n, int ldl, double* b,
+                          int rows, int ldb) {
+  for (int i = 0; i < rows; i++) {
+    double* bi = b + Offset(i, ldb);
+    for (int j = 0; j < n; j++) {
+      const double* lj = l + Offset(j, ldl);
+      double sum = bi[j];
+      for (int t = 0; t < j; t++) {
+        sum -= bi[t] * lj[t];
+      }
+      bi[j] = sum / lj[j];
+    }
+  }
+}
+
+// Right-looking tiled Cholesky of the lower part of a as a task graph:
+// factor the diagonal tile, solve the tiles below it, update the trailing
+// tiles. Tiles are final once factored or solved, so each task only
+// waits for the last writers of the tiles it touches. The upper part of
+// the diagonal tiles is left with garbage.
+void FactorCholesky(double* a, int n, int lda) {
+  const int tiles = (n + kCholeskyTile - 1) / kCholeskyTile;
+  std::vector<int> writers(tiles * tiles, -1);
+  auto writer = [&](int i, int j) -> int& { return writers[i * tiles + j]; };
+  auto width = [n](int tile) {
+    return std::min(kCholeskyTile, n - tile * kCholeskyTile);
+  };
+  S21TaskGraph graph;
+  for (int kt = 0; kt < tiles; kt++) {
+    const int k0 = kt * kCholeskyTile, kb = width(kt);
+    double* diagonal = a + Offset(k0, lda) + k0;
+    writer(kt, kt) = graph.Add([=] { FactorDiagonal(diagonal, kb, lda); },
+                               {writer(kt, kt)});
+    for (int it = kt + 1; it < tiles; it++) {
+      double* tile = a + Offset(it * kCholeskyTile, lda) + k0;
+      writer(it, kt) = graph.Add(
+          [=, ib = width(it)] {
+            SolveLowerTransposed(diagonal, kb, lda, tile, ib, lda);
+          },
+          {writer(kt, kt), writer(it, kt)});
+    }
+    for (int it = kt + 1; it < tiles; it++) {
+      for (int jt = kt + 1; jt <= it; jt++) {
+        const int i0 = it * kCholeskyTile, j0 = jt * kCholeskyTile;
+        // A_ij -= L_ik L_jk^T
+        writer(it, jt) = graph.Add(
+            [=, ib = width(it), jb = width(jt)] {
+              s21::Gemm(ib, jb, kb, -1.0, a + Offset(i0, lda) + k0, lda, 1,
+                        a + Offset(j0, lda) + k0, 1, lda,
+                        a + Offset(i0, lda) + j0, lda);
+            },
+            {writer(it, kt), writer(jt, kt), writer(it, jt)});
+      }
+    }
+  }
+  graph.Run();
+}
+
+}  // namespace
+
+// LU
+
+S21LU::S21LU(const S21Matrix& matrix, Pivoting pivoting)
+    : lu_(matrix), perm_(matrix.GetRows()), sign_(0), rcond_(0) {
+  CheckSquare(lu_);
+  const int n = lu_.GetRows();
+  if (pivoting == Pivoting::kFull) {
+    col_perm_.resize(n);
+    sign_ = s21::LuFactorFull(lu_.data(), n, lu_.stride(), perm_.data(),
+                              col_perm_.data());
+  } else {
+    sign_ = s21::LuFactor(lu_.data(), n, lu_.stride(), perm_.data());
+  }
+  if (sign_ != 0) {
+    rcond_ = s21::LuRcond(lu_.data(), n, lu_.stride(), perm_.data(),
+                          s21::Norm1(matrix.data(), n, n, matrix.stride()));
+  }
+}
+
+S21Matrix S21LU::Solve(const S21Matrix& b) const {
+  S21Matrix x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+void S21LU::SolveInPlace(S21Matrix& b) const {
+  CheckRightSide(b, lu_.GetRows());
+  if (IsSingular()) {
+    throw std::out_of_range("ERROR: calculation impossible: Determinant = 0");
+  }
+  s21::LuSolve(lu_.data(), lu_.GetRows(), lu_.stride(), perm_.data(),
+               b.data(), b.GetCols(), b.stride());
+  if (!col_perm_.empty()) {
+    // x = Q y
+    const S21Matrix y(b);
+    const std::size_t row_bytes = sizeof(double) * b.GetCols();
+    for (int i = 0; i < b.GetRows(); i++) {
+      std::memcpy(b.data() + Offset(col_perm_[i], b.stride()),
+                  y.data() + Offset(i, y.stride()), row_bytes);
+    }
+  }
+}
+
+double S21LU::Determinant() const noexcept {
+  double det = sign_;
+  for (int i = 0; i < lu_.GetRows(); i++) {
+    det *= lu_.data()[Offset(i, lu_.stride()) + i];
+  }
+  return det;
+}
+
+S21Matrix S21LU::Inverse() const {
+  S21Matrix inverse = IdentityMatrix(lu_.GetRows());
+  SolveInPlace(inverse);
+  return inverse;
+}
+
+double S21LU::ConditionNumber() const noexcept {
+  return rcond_ > 0 ? 1 / rcond_ : std::numeric_limits<double>::infinity();
+}
+
+bool S21LU::IsSingular() const noexcept {
+  return sign_ == 0 || s21::RcondSingular<double>(rcond_, lu_.GetRows());
+}
+
+int S21LU::Rank() const noexcept {
+  return s21::LuRank(lu_.data(), lu_.GetRows(), lu_.stride());
+}
+
+// CHOLESKY
+
+S21Cholesky::S21Cholesky(const S21Matrix& matrix) : l_(matrix) {
+  CheckSquare(l_);
+  const int n = l_.GetRows(), ld = l_.stride();
+  double* l = l_.data();
+  FactorCholesky(l, n, ld);
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      l[Offset(i, ld) + j] = 0;
+    }
+  }
+}
+
+S21Matrix S21Cholesky::Solve(const S21Matrix& b) const {
+  S21Matrix x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+void S21Cholesky::SolveInPlace(S21Matrix& b) const {
+  CheckRightSide(b, l_.GetRows());
+  const int n = l_.GetRows(), ld = l_.stride(), ldb = b.stride();
+  const double* l = l_.data();
+  std::vector<double> y(n);
+  for (int c = 0; c < b.GetCols(); c++) {
+    double* x = b.data() + c;
+    // L y = b
+    for (int i = 0; i < n; i++) {
+      const double* li = l + Offset(i, ld);
+      double sum = x[Offset(i, ldb)];
+      for (int t = 0; t < i; t++) {
+        sum -= li[t] * y[t];
+      }
+      y[i] = sum / li[i];
+    }
+    // L^T x = y
+    for (int i = n - 1; i >= 0; i--) {
+      const double* li = l + Offset(i, ld);
+      y[i] /= li[i];
+      for (int t = 0; t < i; t++) {
+        y[t] -= li[t] * y[i];
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      x[Offset(i, ldb)] = y[i];
+    }
+  }
+}
+
+double S21Cholesky::Determinant() const noexcept {
+  double det = 1;
+  for (int i = 0; i < l_.GetRows(); i++) {
+    det *= l_.data()[Offset(i, l_.stride()) + i];
+  }
+  return det * det;
+}
+
+S21Matrix S21Cholesky::Inverse() const {
+  S21Matrix inverse = IdentityMatrix(l_.GetRows());
+  SolveInPlace(inverse);
+  return inverse;
+}
+
+// QR
+
+S21QR::S21QR(const S21Matrix& matrix)
+    : qr_(matrix), tau_(matrix.GetCols()), sign_(1) {
+  const int m = qr_.GetRows(), n = qr_.GetCols(), ld = qr_.stride();
+  if (m < n) {
+    throw std::out_of_range("ERROR: matrix has more columns than rows");
+  }
+  const s21::simd::Kernels& k = s21::simd::Active();
+  double* a = qr_.data();
+  std::vector<double> w(n);
+  for (int j = 0; j < n; j++) {
+    double tail = 0;
+    for (int i = j + 1; i < m; i++) {
+      tail += a[Offset(i, ld) + j] * a[Offset(i, ld) + j];
+    }
+    const double x0 = a[Offset(j, ld) + j];
+    if (tail == 0) {
+      tau_[j] = 0;
+      continue;
+    }
+    const double beta = -std::copysign(std::sqrt(x0 * x0 + tail), x0);
+    tau_[j] = (beta - x0) / beta;
+    const double scale = 1.0 / (x0 - beta);
+    for (int i = j + 1; i < m; i++) {
+      a[Offset(i, ld) + j] *= scale;
+    }
+    a[Offset(j, ld) + j] = beta;
+    sign_ = -sign_;
+    // A[j:, j+1:] -= tau * v * (v^T A[j:, j+1:])
+    const int width = n - j - 1;
+    if (width > 0) {
+      std::copy(a + Offset(j, ld) + j + 1, a + Offset(j, ld) + n, w.begin());
+      for (int i = j + 1; i < m; i++) {
+        k.axpy(w.data(), a + Offset(i, ld) + j + 1, a[Offset(i, ld) + j],
+               width);
+      }
+      k.axpy(a + Offset(j, ld) + j + 1, w.data(), -tau_[j], width);
+      for (int i = j + 1; i < m; i++) {
+        k.axpy(a + Offset(i, ld) + j + 1, w.data(),
+               -tau_[j] * a[Offset(i, ld) + j], width);
+      }
+    }
+  }
+}
+
+void S21QR::ApplyQt(double* x) const {
+  const int m = qr_.GetRows(), n = qr_.GetCols(), ld = qr_.stride();
+  const double* a = qr_.data();
+  for (int j = 0; j < n; j++) {
+    if (tau_[j] == 0) {
+      continue;
+    }
+    double w = x[j];
+    for (int i = j + 1; i < m; i++) {
+      w += a[Offset(i, ld) + j] * x[i];
+    }
+    w *= tau_[j];
+    x[j] -= w;
+    for (int i = j + 1; i < m; i++) {
+      x[i] -= a[Offset(i, ld) + j] * w;
+    }
+  }
+}
+
+S21Matrix S21QR::Solve(const S21Matrix& b) const {
+  S21Matrix x(b);
+  SolveInPlace(x);
+  return x;
+}
+
+void S21QR::SolveInPlace(S21Matrix& b) const {
+  CheckRightSide(b, qr_.GetRows());
+  const int m = qr_.GetRows(), n = qr_.GetCols(), ld = qr_.stride();
+  const int ldb = b.stride();
+  const double* r = qr_.data();
+  // relative to the largest diagonal entry, so the test does not depend
+  // on the scale of the matrix, with the max(m, n) * eps tolerance of a
+  // numerical rank; a zero R gives 0 / 0 and throws as well
+  double r_min = std::numeric_limits<double>::infinity(), r_max = 0;
+  for (int i = 0; i < n; i++) {
+    r_min = std::min(r_min, std::fabs(r[Offset(i, ld) + i]));
+    r_max = std::max(r_max, std::fabs(r[Offset(i, ld) + i]));
+  }
+  if (s21::RcondSingular<double>(r_min / r_max, m)) {
+    throw std::out_of_range(
+        "ERROR: calculation impossible: matrix is rank deficient");
+  }
+  std::vector<double> y(m);
+  for (int c = 0; c < b.GetCols(); c++) {
+    double* x = b.data() + c;
+    for (int i = 0; i < m; i++) {
+      y[i] = x[Offset(i, ldb)];
+    }
+    ApplyQt(y.data());
+    // R x = Q^T b
+    for (int i = n - 1; i >= 0; i--) {
+      const double* ri = r + Offset(i, ld);
+      double sum = y[i];
+      for (int t = i + 1; t < n; t++) {
+        sum -= ri[t] * y[t];
+      }
+      y[i] = sum / ri[i];
+    }
+    for (int i = 0; i < m; i++) {
+      x[Offset(i, ldb)] = y[i];
+    }
+  }
+  if (m > n) {
+    b.SetRows(n);
+  }
+}
+
+double S21QR::Determinant() const {
+  CheckSquare(qr_);
+  double det = sign_;
+  for (int i = 0; i < qr_.GetRows(); i++) {
+    det *= qr_.data()[Offset(i, qr_.stride()) + i];
+  }
+  return det;
+}
+
+S21Matrix S21QR::Inverse() const {
+  CheckSquare(qr_);
+  S21Matrix inverse = IdentityMatrix(qr_.GetRows());
+  SolveInPlace(inverse);
+  return inverse;
+}
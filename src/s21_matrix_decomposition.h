@@ -0,0 +1,78 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_DECOMPOSITION_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_DECOMPOSITION_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Factorizations are computed once in the constructor (O(n^3)); every
+// Solve afterwards costs O(n^2) per right-hand side column.
+
+// PA = LU with partial pivoting, or PAQ = LU with full pivoting, for
+// square matrices. Solve and Inverse throw for matrices that are singular
+// to working precision, judged by the condition number estimated once in
+// the constructor (O(n^2)).
+class S21LU {
+ public:
+  enum class Pivoting { kPartial, kFull };
+
+  explicit S21LU(const S21Matrix& matrix,
+                 Pivoting pivoting = Pivoting::kPartial);
+
+  S21Matrix Solve(const S21Matrix& b) const;
+  void SolveInPlace(S21Matrix& b) const;
+  double Determinant() const noexcept;
+  S21Matrix Inverse() const;
+
+  // estimate of ||A||_1 ||A^-1||_1, infinity if A is singular
+  double ConditionNumber() const noexcept;
+  bool IsSingular() const noexcept;
+  // numerical rank; only reliable with full pivoting
+  int Rank() const noexcept;
+
+ private:
+  S21Matrix lu_;
+  std::vector<int> perm_;
+  // empty with partial pivoting
+  std::vector<int> col_perm_;
+  int sign_;
+  double rcond_;
+};
+
+// A = LL^T, for symmetric positive definite matrices. Large matrices are
+// factored tile by tile on an S21TaskGraph.
+class S21Cholesky {
+ public:
+  explicit S21Cholesky(const S21Matrix& matrix);
+
+  S21Matrix Solve(const S21Matrix& b) const;
+  void SolveInPlace(S21Matrix& b) const;
+  double Determinant() const noexcept;
+  S21Matrix Inverse() const;
+
+ private:
+  S21Matrix l_;
+};
+
+// A = QR by Householder reflections, for rows >= cols. Solve returns the
+// least squares solution when the system is overdetermined, and throws
+// when some |r_ii| is within max(rows, cols) * eps of the largest one.
+class S21QR {
+ public:
+  explicit S21QR(const S21Matrix& matrix);
+
+  S21Matrix Solve(const S21Matrix& b) const;
+  void SolveInPlace(S21Matrix& b) const;
+  double Determinant() const;
+  S21Matrix Inverse() const;
+
+ private:
+  S21Matrix qr_;
+  std::vector<double> tau_;
+  int sign_;
+
+  void ApplyQt(double* x) const;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_DECOMPOSITION_H_
@@ -0,0 +1,293 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_EXPR_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_EXPR_H_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+// Lazy element-wise arithmetic over S21Matrix. An expression such as
+//   r = (s21::Lazy(a) - mean) * scale + s21::Lazy(b).Transpose();
+// is evaluated in one pass into the destination with no temporaries;
+// matrix products inside an expression are computed by s21::Gemm.
+
+namespace s21 {
+
+template <typename E>
+class TransposeExpr;
+
+template <typename E>
+class MatrixExpr {
+ public:
+  const E& Self() const noexcept { return static_cast<const E&>(*this); }
+  TransposeExpr<E> Transpose() const { return TransposeExpr<E>(Self()); }
+  S21Matrix Eval() const { return S21Matrix(*this); }
+};
+
+// Leaf: refers to a matrix that must outlive the expression, or owns the
+// result of a product computed inside the expression.
+class MatrixRef : public MatrixExpr<MatrixRef> {
+ public:
+  explicit MatrixRef(const S21Matrix& matrix) noexcept
+      : data_(matrix.data()),
+        rows_(matrix.GetRows()),
+        cols_(matrix.GetCols()),
+        stride_(matrix.stride()) {}
+  explicit MatrixRef(S21Matrix&& matrix)
+      : owned_(std::make_shared<const S21Matrix>(std::move(matrix))),
+        data_(owned_->data()),
+        rows_(owned_->GetRows()),
+        cols_(owned_->GetCols()),
+        stride_(owned_->stride()) {}
+
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  double At(int i, int j) const noexcept {
+    return data_[static_cast<std::ptrdiff_t>(i) * stride_ + j];
+  }
+  bool Reads(const double* data) const noexcept { return data_ == data; }
+  bool ReadsTransposed(const double*) const noexcept { return false; }
+
+  const double* data() const noexcept { return data_; }
+  int stride() const noexcept { return stride_; }
+
+ private:
+  std::shared_ptr<const S21Matrix> owned_;
+  const double* data_;
+  int rows_, cols_, stride_;
+};
+
+inline MatrixRef Lazy(const S21Matrix& matrix) noexcept {
+  return MatrixRef(matrix);
+}
+
+inline MatrixRef Lazy(S21Matrix&& matrix) {
+  return MatrixRef(std::move(matrix));
+}
+
+struct PlusOp {
+  static double Apply(double a, double b) noexcept { return a + b; }
+};
+
+struct MinusOp {
+  static double Apply(double a, double b) noexcept { return a - b; }
+};
+
+template <typename L, typename R, typename Op>
+class BinaryExpr : public MatrixExpr<BinaryExpr<L, R, Op>> {
+ public:
+  BinaryExpr(const L& left, const R& right) : left_(left), right_(right) {
+    if (left_.GetRows() != right_.GetRows() ||
+        left_.GetCols() != right_.GetCols()) {
+      throw std::out_of_range("ERROR: different dimensions of matrices");
+    }
+  }
+
+  int GetRows() const noexcept { return left_.GetRows(); }
+  int GetCols() const noexcept { return left_.GetCols(); }
+  double At(int i, int j) const noexcept {
+    return Op::Apply(left_.At(i, j), right_.At(i, j));
+  }
+  bool Reads(const double* data) const noexcept {
+    return left_.Reads(data) || right_.Reads(data);
+  }
+  bool ReadsTransposed(const double* data) const noexcept {
+    return left_.ReadsTransposed(data) || right_.ReadsTransposed(data);
+  }
+
+ private:
+  L left_;
+  R right_;
+};
+
+template <typename E>
+class ScaledExpr : public MatrixExpr<ScaledExpr<E>> {
+ public:
+  ScaledExpr(const E& expr, double number) : expr_(expr), number_(number) {}
+
+  int GetRows() const noexcept { return expr_.GetRows(); }
+  int GetCols() const noexcept { return expr_.GetCols(); }
+  double At(int i, int j) const noexcept { return expr_.At(i, j) * number_; }
+  bool Reads(const double* data) const noexcept { return expr_.Reads(data); }
+  bool ReadsTransposed(const double* data) const noexcept {
+    return expr_.ReadsTransposed(data);
+  }
+
+ private:
+  E expr_;
+  double number_;
+};
+
+template <typename E>
+class TransposeExpr : public MatrixExpr<TransposeExpr<E>> {
+ public:
+  explicit TransposeExpr(const E& expr) : expr_(expr) {}
+
+  int GetRows() const noexcept { return expr_.GetCols(); }
+  int GetCols() const noexcept { return expr_.GetRows(); }
+  double At(int i, int j) const noexcept { return expr_.At(j, i); }
+  bool Reads(const double* data) const noexcept { return expr_.Reads(data); }
+  bool ReadsTransposed(const double* data) const noexcept {
+    return expr_.Reads(data);
+  }
+  const E& Inner() const noexcept { return expr_; }
+
+ private:
+  E expr_;
+};
+
+// OPERANDS
+
+template <typename T>
+struct IsMatrixExpr : std::is_base_of<MatrixExpr<T>, T> {};
+
+template <typename T>
+struct IsMatrixOperand
+    : std::integral_constant<bool, IsMatrixExpr<T>::value ||
+                                       std::is_same<T, S21Matrix>::value> {};
+
+inline MatrixRef AsExpr(const S21Matrix& matrix) noexcept {
+  return MatrixRef(matrix);
+}
+
+template <typename E>
+const E& AsExpr(const MatrixExpr<E>& expr) noexcept {
+  return expr.Self();
+}
+
+template <typename T>
+using ExprOf = std::decay_t<decltype(AsExpr(std::declval<const T&>()))>;
+
+// At least one side must be an expression, S21Matrix op S21Matrix keeps
+// its eager overloads.
+template <typename L, typename R>
+using EnableMixed = std::enable_if_t<
+    IsMatrixOperand<L>::value && IsMatrixOperand<R>::value &&
+    (IsMatrixExpr<L>::value || IsMatrixExpr<R>::value)>;
+
+// Operand of a product as seen by s21::Gemm: a pointer and two strides.
+// Leaves and transposed leaves are used in place, anything else is
+// evaluated first.
+struct GemmOperand {
+  std::shared_ptr<const S21Matrix> keep;
+  const double* data;
+  int rows, cols, rs, cs;
+};
+
+inline GemmOperand AsGemmOperand(const MatrixRef& ref) {
+  return {nullptr, ref.data(), ref.GetRows(), ref.GetCols(), ref.stride(), 1};
+}
+
+inline GemmOperand AsGemmOperand(const TransposeExpr<MatrixRef>& expr) {
+  const MatrixRef& ref = expr.Inner();
+  return {nullptr, ref.data(), ref.GetCols(), ref.GetRows(), 1, ref.stride()};
+}
+
+template <typename E>
+GemmOperand AsGemmOperand(const MatrixExpr<E>& expr) {
+  auto keep = std::make_shared<const S21Matrix>(expr);
+  return {keep,           keep->data(), keep->GetRows(),
+          keep->GetCols(), keep->stride(), 1};
+}
+
+// OPERATORS
+
+template <typename L, typename R, typename = EnableMixed<L, R>>
+BinaryExpr<ExprOf<L>, ExprOf<R>, PlusOp> operator+(const L& left,
+                                                   const R& right) {
+  return {AsExpr(left), AsExpr(right)};
+}
+
+template <typename L, typename R, typename = EnableMixed<L, R>>
+BinaryExpr<ExprOf<L>, ExprOf<R>, MinusOp> operator-(const L& left,
+                                                    const R& right) {
+  return {AsExpr(left), AsExpr(right)};
+}
+
+template <typename E>
+ScaledExpr<E> operator*(const MatrixExpr<E>& expr, double number) {
+  return {expr.Self(), number};
+}
+
+template <typename E>
+ScaledExpr<E> operator*(double number, const MatrixExpr<E>& expr) {
+  return {expr.Self(), number};
+}
+
+template <typename E>
+ScaledExpr<E> operator-(const MatrixExpr<E>& expr) {
+  return {expr.Self(), -1.0};
+}
+
+template <typename L, typename R, typename = EnableMixed<L, R>>
+MatrixRef operator*(const L& left, const R& right) {
+  const GemmOperand a = AsGemmOperand(AsExpr(left));
+  const GemmOperand b = AsGemmOperand(AsExpr(right));
+  if (a.rows < 1 || a.cols < 1 || b.rows < 1 || b.cols < 1) {
+    throw std::out_of_range("ERROR: incorrect matrix");
+  }
+  if (a.cols != b.rows) {
+    throw std::out_of_range("ERROR: sides are not equal");
+  }
+  S21Matrix result(a.rows, b.cols);
+  Gemm(a.rows, b.cols, a.cols, 1.0, a.data, a.rs, a.cs, b.data, b.rs, b.cs,
+       result.data(), result.stride());
+  return MatrixRef(std::move(result));
+}
+
+// EVALUATION
+
+template <typename E>
+void EvalInto(const E& expr, double* dst, int stride) {
+  // Rows below this many elements in total are not worth a fork-join.
+  constexpr long kParallelElements = 1L << 16;
+  const int rows = expr.GetRows(), cols = expr.GetCols();
+  auto body = [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = dst + static_cast<std::size_t>(i) * stride;
+      for (int j = 0; j < cols; j++) {
+        row[j] = expr.At(i, j);
+      }
+    }
+  };
+  if (static_cast<long>(rows) * cols < kParallelElements) {
+    body(0, rows);
+  } else {
+    S21ThreadPool::Global().ParallelFor(
+        rows, std::max(1L, kParallelElements / 4 / cols), body);
+  }
+}
+
+}  // namespace s21
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>::S21BasicMatrix(const s21::MatrixExpr<E>& expr)
+    : S21BasicMatrix() {
+  static_assert(std::is_same<T, double>::value,
+                "expressions evaluate into double matrices");
+  MallocMatrix(expr.Self().GetRows(), expr.Self().GetCols());
+  s21::EvalInto(expr.Self(), matrix_, stride_);
+}
+
+template <typename T>
+template <typename E>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(
+    const s21::MatrixExpr<E>& expr) {
+  const E& e = expr.Self();
+  if (rows_ != e.GetRows() || cols_ != e.GetCols() ||
+      e.ReadsTransposed(matrix_)) {
+    *this = S21BasicMatrix(expr);
+  } else {
+    s21::EvalInto(e, data(), stride_);
+  }
+  return *this;
+}
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_EXPR_H_
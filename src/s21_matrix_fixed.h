@@ -0,0 +1,370 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_FIXED_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_FIXED_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_matrix_lu.h"
+#include "s21_matrix_oop.h"
+
+// Matrix with dimensions fixed at compile time and storage inside the
+// object. Meant for the many small (2x2 .. 4x4) matrices of geometric
+// transforms, where the heap allocations and the generic LU path of
+// S21Matrix dominate the cost. Determinant, inverse and complements are
+// closed-form up to 4x4.
+
+template <int R, int C>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "matrix dimensions must be positive");
+
+ public:
+  // Konstructors
+
+  constexpr S21FixedMatrix() noexcept : matrix_{} {}
+  // row-major values
+  constexpr explicit S21FixedMatrix(const double (&values)[R * C]) noexcept
+      : matrix_{} {
+    for (int k = 0; k < R * C; k++) {
+      matrix_[k] = values[k];
+    }
+  }
+  explicit S21FixedMatrix(const S21Matrix& other) : matrix_{} {
+    if (other.GetRows() != R || other.GetCols() != C) {
+      throw std::out_of_range("ERROR: different dimensions of matrices");
+    }
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        matrix_[i * C + j] = other.data()[i * other.stride() + j];
+      }
+    }
+  }
+
+  static constexpr S21FixedMatrix Identity() noexcept {
+    static_assert(R == C, "identity matrix must be square");
+    S21FixedMatrix result;
+    for (int i = 0; i < R; i++) {
+      result.matrix_[i * C + i] = 1;
+    }
+    return result;
+  }
+
+  explicit operator S21Matrix() const {
+    S21Matrix result(R, C);
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        result.data()[i * result.stride() + j] = matrix_[i * C + j];
+      }
+    }
+    return result;
+  }
+
+  // Arithmetics
+
+  constexpr void SumMatrix(const S21FixedMatrix& other) noexcept {
+    for (int k = 0; k < R * C; k++) {
+      matrix_[k] += other.matrix_[k];
+    }
+  }
+
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const noexcept {
+    for (int k = 0; k < R * C; k++) {
+      if (std::fabs(matrix_[k] - other.matrix_[k]) > 1e-6) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr void SubMatrix(const S21FixedMatrix& other) noexcept {
+    for (int k = 0; k < R * C; k++) {
+      matrix_[k] -= other.matrix_[k];
+    }
+  }
+
+  constexpr void MulNumber(const double num) noexcept {
+    for (int k = 0; k < R * C; k++) {
+      matrix_[k] *= num;
+    }
+  }
+
+  constexpr void MulMatrix(const S21FixedMatrix<C, C>& other) noexcept {
+    *this = *this * other;
+  }
+
+  constexpr S21FixedMatrix<C, R> Transpose() const noexcept {
+    S21FixedMatrix<C, R> result;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        result(j, i) = matrix_[i * C + j];
+      }
+    }
+    return result;
+  }
+
+  constexpr double Determinant() const {
+    static_assert(R == C, "determinant of a non-square matrix");
+    if constexpr (R <= 4) {
+      return ClosedDeterminant();
+    } else {
+      std::array<double, R * C> lu = matrix_;
+      std::array<int, R> perm{};
+      double det = s21::LuFactor(lu.data(), R, C, perm.data());
+      for (int i = 0; i < R; i++) {
+        det *= lu[i * C + i];
+      }
+      return det;
+    }
+  }
+
+  S21FixedMatrix InverseMatrix() const {
+    static_assert(R == C, "inverse of a non-square matrix");
+    if constexpr (R <= 4) {
+      const double det = ClosedDeterminant();
+      if (ClosedSingular(det)) {
+        throw std::out_of_range(
+            "ERROR: calculation impossible: Determinant = 0");
+      }
+      S21FixedMatrix result = Adjugate();
+      result.MulNumber(1.0 / det);
+      return result;
+    } else {
+      S21FixedMatrix lu = *this;
+      std::array<int, R> perm{};
+      const int sign = s21::LuFactor(lu.matrix_.data(), R, C, perm.data());
+      S21FixedMatrix result = Identity();
+      if (sign != 0) {
+        s21::LuSolve(lu.matrix_.data(), R, C, perm.data(),
+                     result.matrix_.data(), C, C);
+      }
+      if (sign == 0 ||
+          s21::RcondSingular<double>(1 / (Norm1() * result.Norm1()), R)) {
+        throw std::out_of_range(
+            "ERROR: calculation impossible: Determinant = 0");
+      }
+      return result;
+    }
+  }
+
+  S21FixedMatrix CalcComplements() const {
+    static_assert(R == C, "complements of a non-square matrix");
+    if constexpr (R <= 4) {
+      return Adjugate().Transpose();
+    } else {
+      return S21FixedMatrix(static_cast<S21Matrix>(*this).CalcComplements());
+    }
+  }
+
+  // operators
+
+  constexpr S21FixedMatrix operator+(
+      const S21FixedMatrix& other) const noexcept {
+    S21FixedMatrix res(*this);
+    res.SumMatrix(other);
+    return res;
+  }
+
+  constexpr S21FixedMatrix operator-(
+      const S21FixedMatrix& other) const noexcept {
+    S21FixedMatrix res(*this);
+    res.SubMatrix(other);
+    return res;
+  }
+
+  template <int K>
+  constexpr S21FixedMatrix<R, K> operator*(
+      const S21FixedMatrix<C, K>& other) const noexcept {
+    S21FixedMatrix<R, K> res;
+    for (int i = 0; i < R; i++) {
+      for (int k = 0; k < C; k++) {
+        const double a = matrix_[i * C + k];
+        for (int j = 0; j < K; j++) {
+          res(i, j) += a * other(k, j);
+        }
+      }
+    }
+    return res;
+  }
+
+  constexpr S21FixedMatrix operator*(const double number) const noexcept {
+    S21FixedMatrix res(*this);
+    res.MulNumber(number);
+    return res;
+  }
+
+  friend constexpr S21FixedMatrix operator*(
+      const double number, const S21FixedMatrix& other) noexcept {
+    return other * number;
+  }
+
+  constexpr bool operator==(const S21FixedMatrix& other) const noexcept {
+    return EqMatrix(other);
+  }
+
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) noexcept {
+    SumMatrix(other);
+    return *this;
+  }
+
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) noexcept {
+    SubMatrix(other);
+    return *this;
+  }
+
+  constexpr S21FixedMatrix& operator*=(
+      const S21FixedMatrix<C, C>& other) noexcept {
+    MulMatrix(other);
+    return *this;
+  }
+
+  constexpr S21FixedMatrix& operator*=(const double number) noexcept {
+    MulNumber(number);
+    return *this;
+  }
+
+  // Unchecked: the indices are the caller's responsibility, use At() for a
+  // bounds-checked access.
+  constexpr double& operator()(const int x, const int y) noexcept {
+    return matrix_[x * C + y];
+  }
+  constexpr double operator()(const int x, const int y) const noexcept {
+    return matrix_[x * C + y];
+  }
+
+  double& At(const int x, const int y) {
+    if (x >= R || y >= C || x < 0 || y < 0) {
+      throw std::out_of_range("ERROR: index outside matrix");
+    }
+    return matrix_[x * C + y];
+  }
+
+  // Accessors
+
+  static constexpr int GetRows() noexcept { return R; }
+  static constexpr int GetCols() noexcept { return C; }
+
+  double* data() noexcept { return matrix_.data(); }
+  const double* data() const noexcept { return matrix_.data(); }
+  static constexpr int stride() noexcept { return C; }
+
+ private:
+  std::array<double, R * C> matrix_;
+
+  // help functions
+
+  constexpr double A(int i, int j) const noexcept { return matrix_[i * C + j]; }
+
+  // The condition number ||A|| ||adj A|| / |det| is at most
+  // R ||A||^R / |det| (Hadamard's bound on the cofactors), so the adjugate
+  // is only formed when that bound is not small enough.
+  bool ClosedSingular(double det) const noexcept {
+    const double norm = Norm1();
+    double bound = R * R * std::numeric_limits<double>::epsilon();
+    for (int i = 0; i < R; i++) {
+      bound *= norm;
+    }
+    if (std::fabs(det) > bound) return false;
+    return s21::RcondSingular<double>(
+        std::fabs(det) / (norm * Adjugate().Norm1()), R);
+  }
+
+  // max column sum of absolute values
+  double Norm1() const noexcept {
+    double norm = 0;
+    for (int j = 0; j < C; j++) {
+      double sum = 0;
+      for (int i = 0; i < R; i++) {
+        sum += std::fabs(A(i, j));
+      }
+      norm = std::max(norm, sum);
+    }
+    return norm;
+  }
+
+  constexpr double ClosedDeterminant() const noexcept {
+    if constexpr (R == 1) {
+      return A(0, 0);
+    } else if constexpr (R == 2) {
+      return A(0, 0) * A(1, 1) - A(0, 1) * A(1, 0);
+    } else if constexpr (R == 3) {
+      return A(0, 0) * (A(1, 1) * A(2, 2) - A(1, 2) * A(2, 1)) -
+             A(0, 1) * (A(1, 0) * A(2, 2) - A(1, 2) * A(2, 0)) +
+             A(0, 2) * (A(1, 0) * A(2, 1) - A(1, 1) * A(2, 0));
+    } else {
+      const double s0 = A(0, 0) * A(1, 1) - A(1, 0) * A(0, 1);
+      const double s1 = A(0, 0) * A(1, 2) - A(1, 0) * A(0, 2);
+      const double s2 = A(0, 0) * A(1, 3) - A(1, 0) * A(0, 3);
+      const double s3 = A(0, 1) * A(1, 2) - A(1, 1) * A(0, 2);
+      const double s4 = A(0, 1) * A(1, 3) - A(1, 1) * A(0, 3);
+      const double s5 = A(0, 2) * A(1, 3) - A(1, 2) * A(0, 3);
+      const double c0 = A(2, 0) * A(3, 1) - A(3, 0) * A(2, 1);
+      const double c1 = A(2, 0) * A(3, 2) - A(3, 0) * A(2, 2);
+      const double c2 = A(2, 0) * A(3, 3) - A(3, 0) * A(2, 3);
+      const double c3 = A(2, 1) * A(3, 2) - A(3, 1) * A(2, 2);
+      const double c4 = A(2, 1) * A(3, 3) - A(3, 1) * A(2, 3);
+      const double c5 = A(2, 2) * A(3, 3) - A(3, 2) * A(2, 3);
+      return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+  }
+
+  // adj(A) = det(A) * A^-1, also defined for singular matrices
+  constexpr S21FixedMatrix Adjugate() const noexcept {
+    if constexpr (R == 1) {
+      return S21FixedMatrix({1.0});
+    } else if constexpr (R == 2) {
+      return S21FixedMatrix({A(1, 1), -A(0, 1), -A(1, 0), A(0, 0)});
+    } else if constexpr (R == 3) {
+      return S21FixedMatrix({
+          A(1, 1) * A(2, 2) - A(1, 2) * A(2, 1),
+          A(0, 2) * A(2, 1) - A(0, 1) * A(2, 2),
+          A(0, 1) * A(1, 2) - A(0, 2) * A(1, 1),
+          A(1, 2) * A(2, 0) - A(1, 0) * A(2, 2),
+          A(0, 0) * A(2, 2) - A(0, 2) * A(2, 0),
+          A(0, 2) * A(1, 0) - A(0, 0) * A(1, 2),
+          A(1, 0) * A(2, 1) - A(1, 1) * A(2, 0),
+          A(0, 1) * A(2, 0) - A(0, 0) * A(2, 1),
+          A(0, 0) * A(1, 1) - A(0, 1) * A(1, 0),
+      });
+    } else {
+      const double s0 = A(0, 0) * A(1, 1) - A(1, 0) * A(0, 1);
+      const double s1 = A(0, 0) * A(1, 2) - A(1, 0) * A(0, 2);
+      const double s2 = A(0, 0) * A(1, 3) - A(1, 0) * A(0, 3);
+      const double s3 = A(0, 1) * A(1, 2) - A(1, 1) * A(0, 2);
+      const double s4 = A(0, 1) * A(1, 3) - A(1, 1) * A(0, 3);
+      const double s5 = A(0, 2) * A(1, 3) - A(1, 2) * A(0, 3);
+      const double c0 = A(2, 0) * A(3, 1) - A(3, 0) * A(2, 1);
+      const double c1 = A(2, 0) * A(3, 2) - A(3, 0) * A(2, 2);
+      const double c2 = A(2, 0) * A(3, 3) - A(3, 0) * A(2, 3);
+      const double c3 = A(2, 1) * A(3, 2) - A(3, 1) * A(2, 2);
+      const double c4 = A(2, 1) * A(3, 3) - A(3, 1) * A(2, 3);
+      const double c5 = A(2, 2) * A(3, 3) - A(3, 2) * A(2, 3);
+      return S21FixedMatrix({
+          A(1, 1) * c5 - A(1, 2) * c4 + A(1, 3) * c3,
+          -A(0, 1) * c5 + A(0, 2) * c4 - A(0, 3) * c3,
+          A(3, 1) * s5 - A(3, 2) * s4 + A(3, 3) * s3,
+          -A(2, 1) * s5 + A(2, 2) * s4 - A(2, 3) * s3,
+          -A(1, 0) * c5 + A(1, 2) * c2 - A(1, 3) * c1,
+          A(0, 0) * c5 - A(0, 2) * c2 + A(0, 3) * c1,
+          -A(3, 0) * s5 + A(3, 2) * s2 - A(3, 3) * s1,
+          A(2, 0) * s5 - A(2, 2) * s2 + A(2, 3) * s1,
+          A(1, 0) * c4 - A(1, 1) * c2 + A(1, 3) * c0,
+          -A(0, 0) * c4 + A(0, 1) * c2 - A(0, 3) * c0,
+          A(3, 0) * s4 - A(3, 1) * s2 + A(3, 3) * s0,
+          -A(2, 0) * s4 + A(2, 1) * s2 - A(2, 3) * s0,
+          -A(1, 0) * c3 + A(1, 1) * c1 - A(1, 2) * c0,
+          A(0, 0) * c3 - A(0, 1) * c1 + A(0, 2) * c0,
+          -A(3, 0) * s3 + A(3, 1) * s1 - A(3, 2) * s0,
+          A(2, 0) * s3 - A(2, 1) * s1 + A(2, 2) * s0,
+      });
+    }
+  }
+};
+
+using S21Matrix2 = S21FixedMatrix<2, 2>;
+using S21Matrix3 = S21FixedMatrix<3, 3>;
+using S21Matrix4 = S21FixedMatrix<4, 4>;
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_FIXED_H_
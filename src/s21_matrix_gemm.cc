@@ -0,0 +1,315 @@
+// created by pizpotli
+#include "s21_matrix_gemm.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "s21_matrix_scalar.h"
+#include "s21_task_graph.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Register tile of the micro-kernel and cache blocks: a KC x NR sliver of B
+// stays in L1, an MC x KC block of A in L2 and a KC x NC panel of B in L3.
+constexpr int kMr = 4;
+constexpr int kNr = 8;
+constexpr int kKc = 256;
+constexpr int kMc = 128;
+constexpr int kNc = 4096;
+
+// Products smaller than this many multiply-adds skip packing entirely.
+constexpr long kSmallGemm = 32 * 32 * 32;
+
+// Output tile handed to one thread, and the smallest product worth
+// splitting across the pool.
+constexpr int kTileM = kMc;
+constexpr int kTileN = 256;
+constexpr long kParallelGemm = 128L * 128 * 128;
+
+constexpr std::align_val_t kPackAlignment{64};
+
+// Element offset i * ri + j * rj formed in std::ptrdiff_t: operands of
+// more than 2^31 elements overflow the int product.
+constexpr std::ptrdiff_t Offset(int i, int ri, int j = 0,
+                                int rj = 1) noexcept {
+  return static_cast<std::ptrdiff_t>(i) * ri +
+         static_cast<std::ptrdiff_t>(j) * rj;
+}
+
+// Packing buffers of up to this many bytes are kept by the thread after a
+// product and reused by its next one instead of going back to the heap.
+constexpr std::size_t kKeptPack = std::size_t{2} << 20;
+
+struct KeptPack {
+  void* data = nullptr;
+  std::size_t bytes = 0;
+
+  ~KeptPack() {
+    if (data) ::operator delete[](data, kPackAlignment);
+  }
+};
+
+// One kept buffer per thread for packed A (slot 0), packed B (slot 1) and
+// the widened block of C (slot 2).
+thread_local KeptPack kept_packs[3];
+
+// count elements of the compute type C
+template <typename C>
+class PackBuffer {
+ public:
+  PackBuffer(std::size_t count, int slot) : slot_(slot) {
+    KeptPack& kept = kept_packs[slot_];
+    if (kept.bytes >= count * sizeof(C)) {
+      data_ = kept.data;
+      bytes_ = kept.bytes;
+      kept.data = nullptr;
+      kept.bytes = 0;
+    } else {
+      bytes_ = count * sizeof(C);
+      data_ = ::operator new[](bytes_, kPackAlignment);
+    }
+  }
+  PackBuffer(const PackBuffer&) = delete;
+  PackBuffer& operator=(const PackBuffer&) = delete;
+  ~PackBuffer() {
+    KeptPack& kept = kept_packs[slot_];
+    if (bytes_ <= kKeptPack && bytes_ >= kept.bytes) {
+      std::swap(data_, kept.data);
+      std::swap(bytes_, kept.bytes);
+    }
+    if (data_) ::operator delete[](data_, kPackAlignment);
+  }
+
+  C* get() const noexcept { return static_cast<C*>(data_); }
+
+ private:
+  void* data_;
+  std::size_t bytes_;
+  int slot_;
+};
+
+// Copies an mc x kc block of A into kMr-row slivers, each stored k-major so
+// the micro-kernel reads it with unit stride. Short slivers are zero padded.
+// Elements are widened to the compute type C on the way.
+template <typename T, typename C>
+void PackA(int mc, int kc, const T* a, int rsa, int csa, C* ap) {
+  for (int i0 = 0; i0 < mc; i0 += kMr) {
+    const int mr = std::min(kMr, mc - i0);
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < mr; i++) {
+        ap[i] = static_cast<C>(a[Offset(i0 + i, rsa, p, csa)]);
+      }
+      for (int i = mr; i < kMr; i++) {
+        ap[i] = 0;
+      }
+      ap += kMr;
+    }
+  }
+}
+
+// Copies a kc x nc panel of B into kNr-column slivers stored k-major.
+template <typename T, typename C>
+void PackB(int kc, int nc, const T* b, int rsb, int csb, C* bp) {
+  for (int j0 = 0; j0 < nc; j0 += kNr) {
+    const int nr = std::min(kNr, nc - j0);
+    for (int p = 0; p < kc; p++) {
+      const T* row = b + Offset(p, rsb, j0, csb);
+      for (int j = 0; j < nr; j++) {
+        bp[j] = static_cast<C>(row[Offset(j, csb)]);
+      }
+      for (int j = nr; j < kNr; j++) {
+        bp[j] = 0;
+      }
+      bp += kNr;
+    }
+  }
+}
+
+// kMr x kNr block of C += packed A sliver * packed B sliver. The accumulator
+// tile lives in registers; only the mr x nr valid part is written back.
+template <typename T, typename C>
+void MicroKernel(int kc, C alpha, const C* ap, const C* bp, T* c, int ldc,
+                 int mr, int nr) {
+  C ab[kMr][kNr] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < kMr; i++) {
+      const C aip = ap[i];
+      for (int j = 0; j < kNr; j++) {
+        ab[i][j] += aip * bp[j];
+      }
+    }
+    ap += kMr;
+    bp += kNr;
+  }
+  for (int i = 0; i < mr; i++) {
+    for (int j = 0; j < nr; j++) {
+      T& cij = c[Offset(i, ldc, j)];
+      cij = static_cast<C>(cij) + alpha * ab[i][j];
+    }
+  }
+}
+
+template <typename T>
+void SmallGemm(int m, int n, int k, T alpha, const T* a, int rsa, int csa,
+               const T* b, int rsb, int csb, T* c, int ldc) {
+  for (int i = 0; i < m; i++) {
+    T* ci = c + Offset(i, ldc);
+    for (int p = 0; p < k; p++) {
+      const T aip = alpha * a[Offset(i, rsa, p, csa)];
+      const T* bp = b + Offset(p, rsb);
+      for (int j = 0; j < n; j++) {
+        ci[j] += aip * bp[Offset(j, csb)];
+      }
+    }
+  }
+}
+
+template <typename T, typename C = ComputeType<T>>
+void BlockedGemm(int m, int n, int k, C alpha, const T* a, int rsa, int csa,
+                 const T* b, int rsb, int csb, T* c, int ldc) {
+  const int kc_max = std::min(kKc, k);
+  const int mc_max = std::min(kMc, (m + kMr - 1) / kMr * kMr);
+  const int nc_max = std::min(kNc, (n + kNr - 1) / kNr * kNr);
+  PackBuffer<C> a_pack(static_cast<std::size_t>(mc_max) * kc_max, 0);
+  PackBuffer<C> b_pack(static_cast<std::size_t>(nc_max) * kc_max, 1);
+  if constexpr (kWidened<T>) {
+    // A block of C is summed in the compute type over all of k and
+    // narrowed once; narrowing after every kc slice would round a long sum
+    // k / kKc times. The panel of B is packed again for every block of A.
+    PackBuffer<C> c_wide(static_cast<std::size_t>(mc_max) * nc_max, 2);
+    C* cw = c_wide.get();
+    for (int jc = 0; jc < n; jc += kNc) {
+      const int nc = std::min(kNc, n - jc);
+      for (int ic = 0; ic < m; ic += kMc) {
+        const int mc = std::min(kMc, m - ic);
+        T* cb = c + Offset(ic, ldc, jc);
+        for (int i = 0; i < mc; i++) {
+          for (int j = 0; j < nc; j++) {
+            cw[i * nc + j] = static_cast<C>(cb[Offset(i, ldc, j)]);
+          }
+        }
+        for (int pc = 0; pc < k; pc += kKc) {
+          const int kc = std::min(kKc, k - pc);
+          PackB(kc, nc, b + Offset(pc, rsb, jc, csb), rsb, csb, b_pack.get());
+          PackA(mc, kc, a + Offset(ic, rsa, pc, csa), rsa, csa, a_pack.get());
+          for (int jr = 0; jr < nc; jr += kNr) {
+            const C* bp = b_pack.get() + jr * kc;
+            for (int ir = 0; ir < mc; ir += kMr) {
+              MicroKernel(kc, alpha, a_pack.get() + ir * kc, bp,
+                          cw + ir * nc + jr, nc, std::min(kMr, mc - ir),
+                          std::min(kNr, nc - jr));
+            }
+          }
+        }
+        for (int i = 0; i < mc; i++) {
+          for (int j = 0; j < nc; j++) {
+            cb[Offset(i, ldc, j)] = static_cast<T>(cw[i * nc + j]);
+          }
+        }
+      }
+    }
+  } else {
+    for (int jc = 0; jc < n; jc += kNc) {
+      const int nc = std::min(kNc, n - jc);
+      for (int pc = 0; pc < k; pc += kKc) {
+        const int kc = std::min(kKc, k - pc);
+        PackB(kc, nc, b + Offset(pc, rsb, jc, csb), rsb, csb, b_pack.get());
+        for (int ic = 0; ic < m; ic += kMc) {
+          const int mc = std::min(kMc, m - ic);
+          PackA(mc, kc, a + Offset(ic, rsa, pc, csa), rsa, csa, a_pack.get());
+          for (int jr = 0; jr < nc; jr += kNr) {
+            const C* bp = b_pack.get() + jr * kc;
+            for (int ir = 0; ir < mc; ir += kMr) {
+              MicroKernel(kc, alpha, a_pack.get() + ir * kc, bp,
+                          c + Offset(ic + ir, ldc, jc + jr), ldc,
+                          std::min(kMr, mc - ir), std::min(kNr, nc - jr));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void Gemm(int m, int n, int k, double alpha, const T* a, int rsa, int csa,
+          const T* b, int rsb, int csb, T* c, int ldc) {
+  if (m < 1 || n < 1 || k < 1) {
+    return;
+  }
+  using C = ComputeType<T>;
+  const C factor = static_cast<C>(alpha);
+  const long work = static_cast<long>(m) * n * k;
+  // narrow storage always goes through packing, which widens it
+  if constexpr (!kWidened<T>) {
+    if (work <= kSmallGemm) {
+      SmallGemm(m, n, k, factor, a, rsa, csa, b, rsb, csb, c, ldc);
+      return;
+    }
+  }
+  S21ThreadPool& pool = S21ThreadPool::Global();
+  const int tiles_m = (m + kTileM - 1) / kTileM;
+  const int tiles_n = (n + kTileN - 1) / kTileN;
+  if (work < kParallelGemm || pool.GetThreads() == 1 ||
+      tiles_m * tiles_n == 1) {
+    BlockedGemm(m, n, k, factor, a, rsa, csa, b, rsb, csb, c, ldc);
+    return;
+  }
+  pool.ParallelFor(tiles_m * tiles_n, 1, [&](int begin, int end) {
+    for (int tile = begin; tile < end; tile++) {
+      const int i0 = tile / tiles_n * kTileM, j0 = tile % tiles_n * kTileN;
+      BlockedGemm(std::min(kTileM, m - i0), std::min(kTileN, n - j0), k,
+                  factor, a + Offset(i0, rsa), rsa, csa, b + Offset(j0, csb),
+                  rsb, csb, c + Offset(i0, ldc, j0), ldc);
+    }
+  });
+}
+
+template <typename T>
+void GemmTiled(int m, int n, int k, double alpha, const T* a, int rsa,
+               int csa, const T* b, int rsb, int csb, T* c, int ldc) {
+  S21ThreadPool& pool = S21ThreadPool::Global();
+  const int tiles_m = (m + kTileM - 1) / kTileM;
+  const int tiles_n = (n + kTileN - 1) / kTileN;
+  if (static_cast<long>(m) * n * k < kParallelGemm ||
+      pool.GetThreads() == 1 || tiles_m * tiles_n == 1) {
+    Gemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc);
+    return;
+  }
+  const ComputeType<T> factor = static_cast<ComputeType<T>>(alpha);
+  S21TaskGraph graph;
+  for (int i0 = 0; i0 < m; i0 += kTileM) {
+    for (int j0 = 0; j0 < n; j0 += kTileN) {
+      graph.Add([=] {
+        BlockedGemm(std::min(kTileM, m - i0), std::min(kTileN, n - j0), k,
+                    factor, a + Offset(i0, rsa), rsa, csa,
+                    b + Offset(j0, csb), rsb, csb, c + Offset(i0, ldc, j0),
+                    ldc);
+      });
+    }
+  }
+  graph.Run(pool);
+}
+
+template void Gemm(int, int, int, double, const double*, int, int,
+                   const double*, int, int, double*, int);
+template void Gemm(int, int, int, double, const float*, int, int,
+                   const float*, int, int, float*, int);
+template void Gemm(int, int, int, double, const BFloat16*, int, int,
+                   const BFloat16*, int, int, BFloat16*, int);
+
+template void GemmTiled(int, int, int, double, const double*, int, int,
+                        const double*, int, int, double*, int);
+template void GemmTiled(int, int, int, double, const float*, int, int,
+                        const float*, int, int, float*, int);
+template void GemmTiled(int, int, int, double, const BFloat16*, int, int,
+                        const BFloat16*, int, int, BFloat16*, int);
+
+}  // namespace s21
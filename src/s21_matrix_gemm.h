@@ -0,0 +1,25 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_GEMM_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_GEMM_H_
+
+namespace s21 {
+
+// C(m x n) += alpha * A(m x k) * B(k x n). Element (i, j) of A is read
+// from a[i * rsa + j * csa] (likewise for B), so transposed or strided
+// operands need no copy; C is row-major with leading dimension ldc.
+// T is double, float or BFloat16; products are accumulated in
+// s21::ComputeType<T> over all of k, so C is rounded to T only once.
+template <typename T>
+void Gemm(int m, int n, int k, double alpha, const T* a, int rsa, int csa,
+          const T* b, int rsb, int csb, T* c, int ldc);
+
+// Gemm with the output tiles as tasks of an S21TaskGraph instead of
+// chunks of a ParallelFor: idle threads steal tiles, so uneven tiles do
+// not leave threads waiting at the end. Used by S21Matrix::MulMatrix.
+template <typename T>
+void GemmTiled(int m, int n, int k, double alpha, const T* a, int rsa,
+               int csa, const T* b, int rsb, int csb, T* c, int ldc);
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_GEMM_H_
@@ -0,0 +1,470 @@
+// created by pizpotli
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t kFileAlignment = 64;
+// Verification and checksumming read this many elements at a time.
+constexpr std::size_t kScanElements = 1 << 17;
+
+void ReadFully(int fd, void* buffer, std::size_t bytes, std::uint64_t offset) {
+  char* p = static_cast<char*>(buffer);
+  while (bytes) {
+    const ssize_t done = pread(fd, p, bytes, static_cast<off_t>(offset));
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) {
+      throw std::runtime_error("ERROR: cannot read matrix file");
+    }
+    p += done;
+    bytes -= static_cast<std::size_t>(done);
+    offset += static_cast<std::uint64_t>(done);
+  }
+}
+
+// Makes a rename within the directory of path durable. File systems
+// that cannot sync a directory (EINVAL) need not.
+void SyncDirectory(const std::string& path) {
+  const std::size_t slash = path.find_last_of('/');
+  std::string directory = ".";
+  if (slash != std::string::npos) {
+    directory = slash == 0 ? "/" : path.substr(0, slash);
+  }
+  const int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("ERROR: cannot write " + path);
+  }
+  const bool synced = fsync(fd) == 0 || errno == EINVAL;
+  close(fd);
+  if (!synced) {
+    throw std::runtime_error("ERROR: cannot write " + path);
+  }
+}
+
+void WriteFully(int fd, const void* buffer, std::size_t bytes,
+                std::uint64_t offset) {
+  const char* p = static_cast<const char*>(buffer);
+  while (bytes) {
+    const ssize_t done = pwrite(fd, p, bytes, static_cast<off_t>(offset));
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) {
+      throw std::runtime_error("ERROR: cannot write matrix file");
+    }
+    p += done;
+    bytes -= static_cast<std::size_t>(done);
+    offset += static_cast<std::uint64_t>(done);
+  }
+}
+
+// Checksum of the count elements stored at offset.
+std::uint64_t ScanChecksum(int fd, std::uint64_t offset, std::uint64_t count) {
+  std::vector<double> buffer(std::min<std::uint64_t>(count, kScanElements));
+  s21::MatrixChecksum checksum;
+  while (count) {
+    const std::size_t n = std::min<std::uint64_t>(count, buffer.size());
+    ReadFully(fd, buffer.data(), n * sizeof(double), offset);
+    checksum.Update(buffer.data(), n);
+    offset += n * sizeof(double);
+    count -= n;
+  }
+  return checksum.Digest();
+}
+
+std::uint64_t ElementOffset(std::uint64_t data_offset, int cols, int row,
+                            int col) {
+  return data_offset + (static_cast<std::uint64_t>(row) * cols + col) *
+                           sizeof(double);
+}
+
+}  // namespace
+
+namespace s21 {
+
+void MatrixChecksum::Update(const double* data, std::size_t count) noexcept {
+  // FNV-1a over 64-bit words instead of bytes
+  std::uint64_t state = state_;
+  for (std::size_t i = 0; i < count; i++) {
+    std::uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    state = (state ^ word) * 0x100000001b3ULL;
+  }
+  state_ = state;
+}
+
+std::uint64_t MatrixChecksum::Digest() const noexcept {
+  // final avalanche so that every input bit reaches every output bit
+  std::uint64_t h = state_;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+MatrixFileHeader MakeMatrixFileHeader(int rows, int cols,
+                                      std::uint64_t checksum) noexcept {
+  MatrixFileHeader header{};
+  std::memcpy(header.magic, kMatrixFileMagic, sizeof(header.magic));
+  header.version = kMatrixFileVersion;
+  header.dtype = kMatrixFileFloat64;
+  header.rows = static_cast<std::uint64_t>(rows);
+  header.cols = static_cast<std::uint64_t>(cols);
+  header.alignment = kFileAlignment;
+  header.data_offset = kFileAlignment;
+  header.checksum = checksum;
+  return header;
+}
+
+void CheckMatrixFileHeader(const MatrixFileHeader& header,
+                           std::uint64_t file_size) {
+  if (std::memcmp(header.magic, kMatrixFileMagic, sizeof(header.magic))) {
+    throw std::runtime_error("ERROR: not a matrix file");
+  }
+  if (header.version != kMatrixFileVersion) {
+    throw std::runtime_error("ERROR: unsupported matrix file version");
+  }
+  if (header.dtype != kMatrixFileFloat64) {
+    throw std::runtime_error("ERROR: unsupported element type");
+  }
+  if (header.rows < 1 || header.cols < 1 || header.rows > INT_MAX ||
+      header.cols > INT_MAX) {
+    throw std::runtime_error("ERROR: incorrect matrix");
+  }
+  const std::uint64_t alignment = header.alignment;
+  if (alignment < sizeof(double) || (alignment & (alignment - 1)) ||
+      header.data_offset < sizeof(MatrixFileHeader) ||
+      header.data_offset % alignment) {
+    throw std::runtime_error("ERROR: corrupt matrix file header");
+  }
+  if (header.data_offset > file_size ||
+      (file_size - header.data_offset) / sizeof(double) / header.cols <
+          header.rows) {
+    throw std::runtime_error("ERROR: truncated matrix file");
+  }
+}
+
+}  // namespace s21
+
+// PERSISTENCE
+
+template <typename T>
+void S21BasicMatrix<T>::Save(const std::string& path) const {
+  CheckMistakes2(1);
+  if constexpr (std::is_same<T, double>::value) {
+    S21MatrixWriter writer(path, rows_, cols_);
+    writer.WriteRows(*this);
+    writer.Close();
+  } else {
+    S21Matrix(*this).Save(path);
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Load(const std::string& path) {
+  if constexpr (std::is_same<T, double>::value) {
+    const S21MappedMatrix mapped = S21MappedMatrix::MapFromFile(path);
+    if (!mapped.Verify()) {
+      throw std::runtime_error("ERROR: checksum mismatch in " + path);
+    }
+    return mapped.ToMatrix();
+  } else {
+    return S21BasicMatrix(S21Matrix::Load(path));
+  }
+}
+
+template void S21Matrix::Save(const std::string& path) const;
+template void S21MatrixF::Save(const std::string& path) const;
+template void S21MatrixBF16::Save(const std::string& path) const;
+template S21Matrix S21Matrix::Load(const std::string& path);
+template S21MatrixF S21MatrixF::Load(const std::string& path);
+template S21MatrixBF16 S21MatrixBF16::Load(const std::string& path);
+
+// MAPPED MATRIX
+
+S21MappedMatrix S21MappedMatrix::MapFromFile(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("ERROR: cannot open " + path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) || info.st_size < 0 ||
+      static_cast<std::uint64_t>(info.st_size) <
+          sizeof(s21::MatrixFileHeader)) {
+    close(fd);
+    throw std::runtime_error("ERROR: not a matrix file");
+  }
+  S21MappedMatrix result;
+  result.length_ = static_cast<std::size_t>(info.st_size);
+  void* mapping =
+      mmap(nullptr, result.length_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("ERROR: cannot map " + path);
+  }
+  result.mapping_ = mapping;
+  s21::MatrixFileHeader header;
+  std::memcpy(&header, mapping, sizeof(header));
+  s21::CheckMatrixFileHeader(header, result.length_);
+  result.data_ = reinterpret_cast<const double*>(
+      static_cast<const char*>(mapping) + header.data_offset);
+  result.rows_ = static_cast<int>(header.rows);
+  result.cols_ = static_cast<int>(header.cols);
+  result.checksum_ = header.checksum;
+  return result;
+}
+
+S21MappedMatrix::S21MappedMatrix(S21MappedMatrix&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      length_(std::exchange(other.length_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      rows_(std::exchange(other.rows_, 0)),
+      cols_(std::exchange(other.cols_, 0)),
+      checksum_(other.checksum_) {}
+
+S21MappedMatrix& S21MappedMatrix::operator=(S21MappedMatrix&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    length_ = std::exchange(other.length_, 0);
+    data_ = std::exchange(other.data_, nullptr);
+    rows_ = std::exchange(other.rows_, 0);
+    cols_ = std::exchange(other.cols_, 0);
+    checksum_ = other.checksum_;
+  }
+  return *this;
+}
+
+S21MappedMatrix::~S21MappedMatrix() noexcept { Unmap(); }
+
+bool S21MappedMatrix::Verify() const noexcept {
+  s21::MatrixChecksum checksum;
+  checksum.Update(data_, static_cast<std::size_t>(rows_) * cols_);
+  return checksum.Digest() == checksum_;
+}
+
+S21ConstMatrixView S21MappedMatrix::View() const noexcept {
+  return {data_, rows_, cols_, cols_};
+}
+
+S21Matrix S21MappedMatrix::ToMatrix() const { return View().ToMatrix(); }
+
+double S21MappedMatrix::operator()(const int x, const int y) const {
+  return View()(x, y);
+}
+
+int S21MappedMatrix::GetRows() const noexcept { return rows_; }
+
+int S21MappedMatrix::GetCols() const noexcept { return cols_; }
+
+const double* S21MappedMatrix::data() const noexcept { return data_; }
+
+void S21MappedMatrix::Unmap() noexcept {
+  if (mapping_) {
+    munmap(mapping_, length_);
+    mapping_ = nullptr;
+  }
+}
+
+// READER
+
+S21MatrixReader::S21MatrixReader(const std::string& path)
+    : fd_(open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+  if (fd_ < 0) {
+    throw std::runtime_error("ERROR: cannot open " + path);
+  }
+  try {
+    struct stat info;
+    if (fstat(fd_, &info) || info.st_size < 0 ||
+        static_cast<std::uint64_t>(info.st_size) <
+            sizeof(s21::MatrixFileHeader)) {
+      throw std::runtime_error("ERROR: not a matrix file");
+    }
+    s21::MatrixFileHeader header;
+    ReadFully(fd_, &header, sizeof(header), 0);
+    s21::CheckMatrixFileHeader(header,
+                               static_cast<std::uint64_t>(info.st_size));
+    rows_ = static_cast<int>(header.rows);
+    cols_ = static_cast<int>(header.cols);
+    data_offset_ = header.data_offset;
+    checksum_ = header.checksum;
+  } catch (...) {
+    close(fd_);
+    throw;
+  }
+}
+
+S21MatrixReader::~S21MatrixReader() noexcept { close(fd_); }
+
+void S21MatrixReader::ReadBlock(int row, int col,
+                                const S21MatrixView& dst) const {
+  const int rows = dst.GetRows(), cols = dst.GetCols();
+  if (row < 0 || col < 0 || row + rows > rows_ || col + cols > cols_) {
+    throw std::out_of_range("ERROR: index outside matrix");
+  }
+  if (dst.ColStride() != 1) {
+    S21Matrix block(rows, cols);
+    ReadBlock(row, col, block);
+    dst.Assign(block);
+    return;
+  }
+  const std::size_t row_bytes = sizeof(double) * cols;
+  if (cols == cols_ && dst.RowStride() == cols) {
+    ReadFully(fd_, dst.data(), row_bytes * rows,
+              ElementOffset(data_offset_, cols_, row, 0));
+    return;
+  }
+  for (int i = 0; i < rows; i++) {
+    double* row_data =
+        dst.data() + static_cast<std::ptrdiff_t>(i) * dst.RowStride();
+    ReadFully(fd_, row_data, row_bytes,
+              ElementOffset(data_offset_, cols_, row + i, col));
+  }
+}
+
+int S21MatrixReader::ReadRows(const S21MatrixView& chunk) {
+  if (chunk.GetCols() != cols_) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+  const int count = std::min(chunk.GetRows(), rows_ - next_row_);
+  if (count > 0) {
+    ReadBlock(next_row_, 0, chunk.Block(0, 0, count, cols_));
+    next_row_ += count;
+  }
+  return count;
+}
+
+bool S21MatrixReader::Verify() const {
+  return ScanChecksum(fd_, data_offset_,
+                      static_cast<std::uint64_t>(rows_) * cols_) == checksum_;
+}
+
+int S21MatrixReader::GetRows() const noexcept { return rows_; }
+
+int S21MatrixReader::GetCols() const noexcept { return cols_; }
+
+// WRITER
+
+S21MatrixWriter::S21MatrixWriter(const std::string& path, int rows, int cols)
+    : path_(path), temporary_(), fd_(-1), rows_(rows), cols_(cols) {
+  if (rows < 1 || cols < 1) {
+    throw std::out_of_range("ERROR: incorrect matrix");
+  }
+  // a name of its own next to path, so concurrent writers to one path do
+  // not share a temporary and the rename stays within one file system
+  std::vector<char> name(path.begin(), path.end());
+  const char suffix[] = ".XXXXXX";
+  name.insert(name.end(), suffix, suffix + sizeof(suffix));
+  fd_ = mkstemp(name.data());
+  if (fd_ < 0) {
+    throw std::runtime_error("ERROR: cannot write " + path);
+  }
+  temporary_ = name.data();
+  // mkstemp creates the file 0600; readable by others like any saved file
+  if (fcntl(fd_, F_SETFD, FD_CLOEXEC) || fchmod(fd_, 0644)) {
+    close(fd_);
+    std::remove(temporary_.c_str());
+    throw std::runtime_error("ERROR: cannot write " + path);
+  }
+  // full length up front, so blocks can be stored in any order
+  if (ftruncate(fd_, static_cast<off_t>(
+                         ElementOffset(kFileAlignment, cols, rows, 0)))) {
+    close(fd_);
+    std::remove(temporary_.c_str());
+    throw std::runtime_error("ERROR: cannot write " + path);
+  }
+}
+
+S21MatrixWriter::~S21MatrixWriter() noexcept {
+  if (fd_ >= 0) {
+    close(fd_);
+    std::remove(temporary_.c_str());
+  }
+}
+
+void S21MatrixWriter::WriteBlock(int row, int col,
+                                 const S21ConstMatrixView& block) {
+  const int rows = block.GetRows(), cols = block.GetCols();
+  if (fd_ < 0) {
+    throw std::runtime_error("ERROR: writer is closed");
+  }
+  if (row < 0 || col < 0 || row + rows > rows_ || col + cols > cols_) {
+    throw std::out_of_range("ERROR: index outside matrix");
+  }
+  if (block.ColStride() != 1) {
+    WriteBlock(row, col, block.ToMatrix());
+    return;
+  }
+  const bool appended = in_order_ && row == next_row_ && cols == cols_;
+  const std::size_t row_bytes = sizeof(double) * cols;
+  if (cols == cols_ && block.RowStride() == cols) {
+    // the rows are contiguous in memory as in the file
+    if (appended) {
+      checksum_.Update(block.data(), static_cast<std::size_t>(rows) * cols);
+    }
+    WriteFully(fd_, block.data(), row_bytes * rows,
+               ElementOffset(kFileAlignment, cols_, row, 0));
+  } else {
+    for (int i = 0; i < rows; i++) {
+      const double* src =
+          block.data() + static_cast<std::ptrdiff_t>(i) * block.RowStride();
+      if (appended) checksum_.Update(src, cols);
+      WriteFully(fd_, src, row_bytes,
+                 ElementOffset(kFileAlignment, cols_, row + i, col));
+    }
+  }
+  if (appended) {
+    next_row_ += rows;
+  } else {
+    in_order_ = false;
+  }
+}
+
+void S21MatrixWriter::WriteRows(const S21ConstMatrixView& rows) {
+  if (rows.GetCols() != cols_) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+  WriteBlock(next_row_, 0, rows);
+}
+
+void S21MatrixWriter::Close() {
+  if (fd_ < 0) {
+    throw std::runtime_error("ERROR: writer is closed");
+  }
+  s21::MatrixFileHeader header = s21::MakeMatrixFileHeader(rows_, cols_, 0);
+  header.checksum =
+      in_order_ && next_row_ == rows_
+          ? checksum_.Digest()
+          : ScanChecksum(fd_, header.data_offset,
+                         static_cast<std::uint64_t>(rows_) * cols_);
+  WriteFully(fd_, &header, sizeof(header), 0);
+  const int fd = std::exchange(fd_, -1);
+  // the contents reach the disk before the rename can, so a crash leaves
+  // either the old file or the complete new one; readers that have the
+  // old file mapped keep seeing it intact
+  const bool synced = fsync(fd) == 0;
+  if (close(fd) || !synced ||
+      std::rename(temporary_.c_str(), path_.c_str())) {
+    std::remove(temporary_.c_str());
+    throw std::runtime_error("ERROR: cannot write " + path_);
+  }
+  SyncDirectory(path_);
+}
+
+int S21MatrixWriter::GetRows() const noexcept { return rows_; }
+
+int S21MatrixWriter::GetCols() const noexcept { return cols_; }
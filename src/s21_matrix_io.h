@@ -0,0 +1,160 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_IO_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_view.h"
+
+// Binary matrix files: a 64-byte header followed by the elements as
+// row-major doubles in native byte order without padding between rows (a
+// file from a host of the other byte order fails the version check). The
+// data starts at MatrixFileHeader::data_offset, a multiple of the recorded
+// alignment, so a mapped file can be used in place.
+
+namespace s21 {
+
+constexpr char kMatrixFileMagic[8] = {'S', '2', '1', 'M', 'T', 'R', 'X', '\0'};
+constexpr std::uint32_t kMatrixFileVersion = 1;
+constexpr std::uint32_t kMatrixFileFloat64 = 1;
+
+struct MatrixFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t dtype;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t alignment;
+  std::uint64_t data_offset;
+  // MatrixChecksum of the elements
+  std::uint64_t checksum;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(MatrixFileHeader) == 64, "header layout is fixed");
+
+// Incremental 64-bit checksum over the elements in file order; feeding the
+// data in pieces gives the same digest as feeding it at once.
+class MatrixChecksum {
+ public:
+  void Update(const double* data, std::size_t count) noexcept;
+  std::uint64_t Digest() const noexcept;
+
+ private:
+  std::uint64_t state_ = 0xcbf29ce484222325ULL;
+};
+
+// Header for a rows x cols matrix with the given checksum.
+MatrixFileHeader MakeMatrixFileHeader(int rows, int cols,
+                                      std::uint64_t checksum) noexcept;
+// Throws std::runtime_error unless header describes a file of file_size
+// bytes this version can read.
+void CheckMatrixFileHeader(const MatrixFileHeader& header,
+                           std::uint64_t file_size);
+
+}  // namespace s21
+
+// Read-only matrix backed directly by a memory-mapped matrix file: mapping
+// costs the same for any size, pages are read on first touch and shared
+// with every other process mapping the same file through the page cache.
+// The file must not be modified while mapped; S21Matrix::Save replaces a
+// file instead of rewriting it, so saving over a mapped file is safe.
+class S21MappedMatrix {
+ public:
+  // Validates the header but not the checksum, which would read the whole
+  // file; call Verify() for that.
+  static S21MappedMatrix MapFromFile(const std::string& path);
+
+  S21MappedMatrix(S21MappedMatrix&& other) noexcept;
+  S21MappedMatrix& operator=(S21MappedMatrix&& other) noexcept;
+  S21MappedMatrix(const S21MappedMatrix&) = delete;
+  S21MappedMatrix& operator=(const S21MappedMatrix&) = delete;
+  ~S21MappedMatrix() noexcept;
+
+  // true if the elements match the checksum in the header
+  bool Verify() const noexcept;
+  S21ConstMatrixView View() const noexcept;
+  S21Matrix ToMatrix() const;
+  double operator()(const int x, const int y) const;
+
+  // Accessors
+
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+  const double* data() const noexcept;
+
+ private:
+  void* mapping_ = nullptr;
+  std::size_t length_ = 0;
+  const double* data_ = nullptr;
+  int rows_ = 0, cols_ = 0;
+  std::uint64_t checksum_ = 0;
+
+  S21MappedMatrix() noexcept = default;
+
+  void Unmap() noexcept;
+};
+
+// Reads a matrix file piecewise with positioned reads, for matrices that
+// do not fit in memory. ReadBlock may be called from several threads.
+class S21MatrixReader {
+ public:
+  explicit S21MatrixReader(const std::string& path);
+  S21MatrixReader(const S21MatrixReader&) = delete;
+  S21MatrixReader& operator=(const S21MatrixReader&) = delete;
+  ~S21MatrixReader() noexcept;
+
+  // Fills dst with the block of its size whose top left corner is (row, col)
+  void ReadBlock(int row, int col, const S21MatrixView& dst) const;
+  // Reads the next rows in file order into the top of chunk, which must be
+  // as wide as the matrix; returns how many, 0 at the end.
+  int ReadRows(const S21MatrixView& chunk);
+  // true if the elements match the checksum in the header; reads the file
+  bool Verify() const;
+
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+
+ private:
+  int fd_;
+  int rows_, cols_;
+  int next_row_ = 0;
+  std::uint64_t data_offset_, checksum_;
+};
+
+// Writes a matrix file piecewise. The file appears at path only after a
+// successful Close(), atomically like S21Matrix::Save and synced to disk
+// first, so a crash leaves the old file or the new one whole; a writer
+// destroyed without Close() leaves nothing behind. Writers to one path
+// may run at the same time: the last to close wins. Rows written by
+// WriteRows in file order are checksummed on the fly, anything else is
+// read back on Close().
+class S21MatrixWriter {
+ public:
+  S21MatrixWriter(const std::string& path, int rows, int cols);
+  S21MatrixWriter(const S21MatrixWriter&) = delete;
+  S21MatrixWriter& operator=(const S21MatrixWriter&) = delete;
+  ~S21MatrixWriter() noexcept;
+
+  // Stores block with its top left corner at (row, col).
+  void WriteBlock(int row, int col, const S21ConstMatrixView& block);
+  // Appends rows, as wide as the matrix, after those appended before.
+  void WriteRows(const S21ConstMatrixView& rows);
+  void Close();
+
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+
+ private:
+  std::string path_, temporary_;
+  int fd_;
+  int rows_, cols_;
+  int next_row_ = 0;
+  // false once a block was written out of order
+  bool in_order_ = true;
+  s21::MatrixChecksum checksum_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_IO_H_
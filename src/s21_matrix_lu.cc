@@ -0,0 +1,438 @@
+// created by pizpotli
+#include "s21_matrix_lu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_scalar.h"
+#include "s21_matrix_simd.h"
+#include "s21_task_graph.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Panel width of the blocked factorization; the trailing update of each
+// panel is a single GEMM call.
+constexpr int kLuBlock = 64;
+
+// Right-hand sides narrower than this are solved column by column with
+// dot products instead of whole-row updates.
+constexpr int kNarrowSolve = 4;
+
+// Columns summed at once by Norm1.
+constexpr int kNormStrip = 256;
+
+// Row offset i * ld formed in std::ptrdiff_t: matrices of more than 2^31
+// elements overflow the int product.
+constexpr std::ptrdiff_t Offset(int i, int ld) noexcept {
+  return static_cast<std::ptrdiff_t>(i) * ld;
+}
+
+// Tiles of LuFactorTiled, wider than the panels of LuFactorBlocked so
+// that the GEMM tasks amortize their packing; and the size from which
+// LuFactor prefers the task graph when there are threads to run it.
+constexpr int kLuTile = 128;
+constexpr int kTiledLu = 512;
+
+// Unblocked elimination of columns [k0, k0 + kb) over rows [k0, n). Row
+// swaps are applied to columns [c0, c1); row j is exchanged with row
+// pivots[j] if pivots is not null.
+template <typename T>
+int FactorPanel(T* a, int n, int lda, int k0, int kb, int c0, int c1,
+                int* perm, int* pivots) {
+  const simd::BasicKernels<T>& k = simd::Active<T>();
+  int sign = 1;
+  for (int j = k0; j < k0 + kb; j++) {
+    int pivot = j;
+    for (int i = j + 1; i < n; i++) {
+      if (std::fabs(a[Offset(i, lda) + j]) >
+          std::fabs(a[Offset(pivot, lda) + j])) {
+        pivot = i;
+      }
+    }
+    if (pivots) pivots[j] = pivot;
+    if (pivot != j) {
+      std::swap_ranges(a + Offset(j, lda) + c0, a + Offset(j, lda) + c1,
+                       a + Offset(pivot, lda) + c0);
+      std::swap(perm[j], perm[pivot]);
+      sign = -sign;
+    }
+    const T diag = a[Offset(j, lda) + j];
+    if (diag == 0) {
+      sign = 0;
+      continue;
+    }
+    for (int i = j + 1; i < n; i++) {
+      T* row = a + Offset(i, lda);
+      row[j] /= diag;
+      k.axpy(row + j + 1, a + Offset(j, lda) + j + 1, -row[j], k0 + kb - j - 1);
+    }
+  }
+  return sign;
+}
+
+// Rows [k0, k0 + kb) exchanged as recorded by FactorPanel, in columns
+// [c0, c0 + cb)
+template <typename T>
+void SwapRows(T* a, int lda, int k0, int kb, int c0, int cb,
+              const int* pivots) {
+  for (int j = k0; j < k0 + kb; j++) {
+    if (pivots[j] != j) {
+      std::swap_ranges(a + Offset(j, lda) + c0, a + Offset(j, lda) + c0 + cb,
+                       a + Offset(pivots[j], lda) + c0);
+    }
+  }
+}
+
+// Rows [k0, k0 + kb) of columns [c0, c0 + cb) times L11^-1, where L11 is
+// the unit lower triangle of the diagonal block at k0
+template <typename T>
+void SolveUnitLower(T* a, int lda, int k0, int kb, int c0, int cb) {
+  const simd::BasicKernels<T>& k = simd::Active<T>();
+  for (int i = k0 + 1; i < k0 + kb; i++) {
+    for (int t = k0; t < i; t++) {
+      k.axpy(a + Offset(i, lda) + c0, a + Offset(t, lda) + c0,
+             -a[Offset(i, lda) + t], cb);
+    }
+  }
+}
+
+// A^T x = b for one column: U^T z = b, L^T w = z, x = P^T w
+template <typename T>
+void SolveTransposedColumn(const T* lu, int n, int ldlu, const int* perm,
+                           const T* b, T* x, T* w) {
+  for (int i = 0; i < n; i++) {
+    T sum = b[i];
+    for (int t = 0; t < i; t++) {
+      sum -= lu[Offset(t, ldlu) + i] * w[t];
+    }
+    w[i] = sum / lu[Offset(i, ldlu) + i];
+  }
+  for (int i = n - 2; i >= 0; i--) {
+    T sum = w[i];
+    for (int t = i + 1; t < n; t++) {
+      sum -= lu[Offset(t, ldlu) + i] * w[t];
+    }
+    w[i] = sum;
+  }
+  for (int i = 0; i < n; i++) {
+    x[perm[i]] = w[i];
+  }
+}
+
+template <typename T>
+double SumAbs(const std::vector<T>& x) {
+  double sum = 0;
+  for (T value : x) {
+    sum += std::fabs(static_cast<double>(value));
+  }
+  return sum;
+}
+
+template <typename T>
+void SolveColumn(const T* lu, int n, int ldlu, const int* perm, T* b,
+                 int ldb, T* y) {
+  for (int i = 0; i < n; i++) {
+    y[i] = b[Offset(perm[i], ldb)];
+  }
+  for (int i = 1; i < n; i++) {
+    const T* row = lu + Offset(i, ldlu);
+    T sum = y[i];
+    for (int t = 0; t < i; t++) {
+      sum -= row[t] * y[t];
+    }
+    y[i] = sum;
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    const T* row = lu + Offset(i, ldlu);
+    T sum = y[i];
+    for (int t = i + 1; t < n; t++) {
+      sum -= row[t] * y[t];
+    }
+    y[i] = sum / row[i];
+  }
+  for (int i = 0; i < n; i++) {
+    b[Offset(i, ldb)] = y[i];
+  }
+}
+
+}  // namespace
+
+template <typename T>
+int LuFactor(T* a, int n, int lda, int* perm) {
+  if (n >= kTiledLu && S21ThreadPool::Global().GetThreads() > 1) {
+    return LuFactorTiled(a, n, lda, perm);
+  }
+  return LuFactorBlocked(a, n, lda, perm);
+}
+
+template <typename T>
+int LuFactorBlocked(T* a, int n, int lda, int* perm) {
+  for (int i = 0; i < n; i++) {
+    perm[i] = i;
+  }
+  int sign = 1;
+  for (int k0 = 0; k0 < n; k0 += kLuBlock) {
+    const int kb = std::min(kLuBlock, n - k0);
+    const int right = k0 + kb;
+    sign *= FactorPanel(a, n, lda, k0, kb, 0, n, perm, nullptr);
+    if (right < n) {
+      // U12 = L11^-1 * A12, independent per column range
+      S21ThreadPool::Global().ParallelFor(
+          n - right, kLuBlock, [&](int begin, int end) {
+            SolveUnitLower(a, lda, k0, kb, right + begin, end - begin);
+          });
+      // A22 -= L21 * U12
+      Gemm(n - right, n - right, kb, -1.0, a + Offset(right, lda) + k0, lda,
+           1, a + Offset(k0, lda) + right, lda, 1,
+           a + Offset(right, lda) + right, lda);
+    }
+  }
+  return sign;
+}
+
+template <typename T>
+int LuFactorTiled(T* a, int n, int lda, int* perm) {
+  for (int i = 0; i < n; i++) {
+    perm[i] = i;
+  }
+  const int tiles = (n + kLuTile - 1) / kLuTile;
+  std::vector<int> pivots(n), signs(tiles);
+  // last task writing tile (i, j), -1 before the first. Tracking writers
+  // is enough: L and U tiles are final once written, the row swaps of
+  // later panels on L are applied after the graph.
+  std::vector<int> writers(tiles * tiles, -1);
+  auto writer = [&](int i, int j) -> int& { return writers[i * tiles + j]; };
+  auto width = [n](int tile) { return std::min(kLuTile, n - tile * kLuTile); };
+  S21TaskGraph graph;
+  for (int kt = 0; kt < tiles; kt++) {
+    const int k0 = kt * kLuTile, kb = width(kt);
+    std::vector<int> after;
+    for (int it = kt; it < tiles; it++) after.push_back(writer(it, kt));
+    const int panel = graph.Add(
+        [=, &pivots, &signs] {
+          signs[kt] = FactorPanel(a, n, lda, k0, kb, k0, k0 + kb, perm,
+                                  pivots.data());
+        },
+        after);
+    for (int it = kt; it < tiles; it++) writer(it, kt) = panel;
+    for (int jt = kt + 1; jt < tiles; jt++) {
+      const int j0 = jt * kLuTile, jb = width(jt);
+      after.assign(1, panel);
+      for (int it = kt; it < tiles; it++) after.push_back(writer(it, jt));
+      // the panel's swaps on this column, then U_kj = L_kk^-1 A_kj
+      const int row = graph.Add(
+          [=, &pivots] {
+            SwapRows(a, lda, k0, kb, j0, jb, pivots.data());
+            SolveUnitLower(a, lda, k0, kb, j0, jb);
+          },
+          after);
+      for (int it = kt; it < tiles; it++) writer(it, jt) = row;
+      for (int it = kt + 1; it < tiles; it++) {
+        const int i0 = it * kLuTile, ib = width(it);
+        // A_ij -= L_ik U_kj
+        writer(it, jt) = graph.Add(
+            [=] {
+              Gemm(ib, jb, kb, -1.0, a + Offset(i0, lda) + k0, lda, 1,
+                   a + Offset(k0, lda) + j0, lda, 1,
+                   a + Offset(i0, lda) + j0, lda);
+            },
+            {panel, row});
+      }
+    }
+  }
+  graph.Run();
+  S21ThreadPool::Global().ParallelFor(n, kLuTile, [&](int begin, int end) {
+    for (int k0 = kLuTile; k0 < n; k0 += kLuTile) {
+      if (begin < k0) {
+        SwapRows(a, lda, k0, std::min(kLuTile, n - k0), begin,
+                 std::min(end, k0) - begin, pivots.data());
+      }
+    }
+  });
+  int sign = 1;
+  for (int value : signs) sign *= value;
+  return sign;
+}
+
+template <typename T>
+void LuSolve(const T* lu, int n, int ldlu, const int* perm, T* b, int nrhs,
+             int ldb) {
+  if (nrhs < kNarrowSolve) {
+    std::vector<T> y(n);
+    for (int c = 0; c < nrhs; c++) {
+      SolveColumn(lu, n, ldlu, perm, b + c, ldb, y.data());
+    }
+    return;
+  }
+  const simd::BasicKernels<T>& k = simd::Active<T>();
+  const std::size_t row_bytes = sizeof(T) * nrhs;
+  std::vector<T> permuted(static_cast<std::size_t>(n) * nrhs);
+  for (int i = 0; i < n; i++) {
+    std::memcpy(&permuted[static_cast<std::size_t>(i) * nrhs],
+                b + Offset(perm[i], ldb), row_bytes);
+  }
+  for (int i = 0; i < n; i++) {
+    std::memcpy(b + Offset(i, ldb),
+                &permuted[static_cast<std::size_t>(i) * nrhs], row_bytes);
+  }
+  for (int i = 1; i < n; i++) {
+    for (int t = 0; t < i; t++) {
+      k.axpy(b + Offset(i, ldb), b + Offset(t, ldb), -lu[Offset(i, ldlu) + t],
+             nrhs);
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    for (int t = i + 1; t < n; t++) {
+      k.axpy(b + Offset(i, ldb), b + Offset(t, ldb), -lu[Offset(i, ldlu) + t],
+             nrhs);
+    }
+    k.scale(b + Offset(i, ldb), 1 / lu[Offset(i, ldlu) + i], nrhs);
+  }
+}
+
+template <typename T>
+int LuFactorFull(T* a, int n, int lda, int* perm, int* col_perm) {
+  const simd::BasicKernels<T>& k = simd::Active<T>();
+  for (int i = 0; i < n; i++) {
+    perm[i] = col_perm[i] = i;
+  }
+  int sign = 1;
+  for (int j = 0; j < n; j++) {
+    int pivot_row = j, pivot_col = j;
+    T largest = 0;
+    for (int i = j; i < n; i++) {
+      for (int c = j; c < n; c++) {
+        if (std::fabs(a[Offset(i, lda) + c]) > largest) {
+          largest = std::fabs(a[Offset(i, lda) + c]);
+          pivot_row = i;
+          pivot_col = c;
+        }
+      }
+    }
+    if (largest == 0) {
+      // the rest is exactly zero
+      return 0;
+    }
+    if (pivot_row != j) {
+      std::swap_ranges(a + Offset(j, lda), a + Offset(j, lda) + n,
+                       a + Offset(pivot_row, lda));
+      std::swap(perm[j], perm[pivot_row]);
+      sign = -sign;
+    }
+    if (pivot_col != j) {
+      for (int i = 0; i < n; i++) {
+        std::swap(a[Offset(i, lda) + j], a[Offset(i, lda) + pivot_col]);
+      }
+      std::swap(col_perm[j], col_perm[pivot_col]);
+      sign = -sign;
+    }
+    const T diag = a[Offset(j, lda) + j];
+    for (int i = j + 1; i < n; i++) {
+      T* row = a + Offset(i, lda);
+      row[j] /= diag;
+      k.axpy(row + j + 1, a + Offset(j, lda) + j + 1, -row[j], n - j - 1);
+    }
+  }
+  return sign;
+}
+
+template <typename T>
+double Norm1(const T* a, int rows, int cols, int lda) {
+  // row-wise over strips of columns; no allocation for the small fixed-size
+  // matrices that call this on every inverse
+  double norm = 0, sums[kNormStrip];
+  for (int j0 = 0; j0 < cols; j0 += kNormStrip) {
+    const int width = std::min(kNormStrip, cols - j0);
+    std::fill(sums, sums + width, 0.0);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < width; j++) {
+        sums[j] += std::fabs(static_cast<double>(a[Offset(i, lda) + j0 + j]));
+      }
+    }
+    norm = std::max(norm, *std::max_element(sums, sums + width));
+  }
+  return norm;
+}
+
+template <typename T>
+double LuRcond(const T* lu, int n, int ldlu, const int* perm, double norm) {
+  for (int i = 0; i < n; i++) {
+    if (lu[Offset(i, ldlu) + i] == 0) return 0;
+  }
+  if (norm == 0) return 0;
+  // estimate ||A^-1||_1 = max ||A^-1 x||_1 over ||x||_1 = 1 by climbing
+  // from x = (1/n, ..., 1/n) to the unit vector of the largest gradient
+  std::vector<T> x(n, T(1) / n), y(n), z(n), w(n);
+  double estimate = 0;
+  for (int iteration = 0; iteration < 5; iteration++) {
+    y = x;
+    LuSolve(lu, n, ldlu, perm, y.data(), 1, 1);
+    const double next = SumAbs(y);
+    if (iteration > 0 && next <= estimate) break;
+    estimate = next;
+    for (int i = 0; i < n; i++) {
+      y[i] = y[i] >= 0 ? 1 : -1;
+    }
+    SolveTransposedColumn(lu, n, ldlu, perm, y.data(), z.data(), w.data());
+    int j = 0;
+    double dot = 0;
+    for (int i = 0; i < n; i++) {
+      if (std::fabs(z[i]) > std::fabs(z[j])) j = i;
+      dot += static_cast<double>(z[i]) * x[i];
+    }
+    if (iteration > 0 && std::fabs(z[j]) <= dot) break;
+    std::fill(x.begin(), x.end(), T(0));
+    x[j] = 1;
+  }
+  // alternating test vector that catches the cases the climb misses
+  for (int i = 0; i < n; i++) {
+    x[i] = (i % 2 ? -1 : 1) * (1 + (n > 1 ? T(i) / (n - 1) : T(0)));
+  }
+  LuSolve(lu, n, ldlu, perm, x.data(), 1, 1);
+  estimate = std::max(estimate, 2 * SumAbs(x) / (3 * n));
+  return std::isfinite(estimate) ? 1 / (norm * estimate) : 0;
+}
+
+template <typename T>
+int LuRank(const T* lu, int n, int ldlu) {
+  std::vector<double> pivots(n);
+  for (int i = 0; i < n; i++) {
+    pivots[i] = std::fabs(static_cast<double>(lu[Offset(i, ldlu) + i]));
+  }
+  const double largest =
+      n ? *std::max_element(pivots.begin(), pivots.end()) : 0;
+  const double tolerance = n * largest * std::numeric_limits<T>::epsilon();
+  int rank = 0;
+  for (double pivot : pivots) {
+    rank += pivot > tolerance;
+  }
+  return rank;
+}
+
+template int LuFactor(double*, int, int, int*);
+template int LuFactor(float*, int, int, int*);
+template int LuFactorBlocked(double*, int, int, int*);
+template int LuFactorBlocked(float*, int, int, int*);
+template int LuFactorTiled(double*, int, int, int*);
+template int LuFactorTiled(float*, int, int, int*);
+template void LuSolve(const double*, int, int, const int*, double*, int, int);
+template void LuSolve(const float*, int, int, const int*, float*, int, int);
+template int LuFactorFull(double*, int, int, int*, int*);
+template int LuFactorFull(float*, int, int, int*, int*);
+template double Norm1(const double*, int, int, int);
+template double Norm1(const float*, int, int, int);
+template double Norm1(const BFloat16*, int, int, int);
+template double LuRcond(const double*, int, int, const int*, double);
+template double LuRcond(const float*, int, int, const int*, double);
+template int LuRank(const double*, int, int);
+template int LuRank(const float*, int, int);
+
+}  // namespace s21
@@ -0,0 +1,69 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_LU_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_LU_H_
+
+#include <limits>
+
+namespace s21 {
+
+// In-place LU factorization with partial pivoting of the n x n row-major
+// matrix a: on return the strictly lower part holds L (unit diagonal), the
+// upper part holds U and row i of PA is row perm[i] of the original matrix.
+// Returns the sign of the permutation, or 0 if a zero pivot was met.
+// T is double or float. Large matrices go to LuFactorTiled when the
+// global pool has more than one thread, the rest to LuFactorBlocked.
+template <typename T>
+int LuFactor(T* a, int n, int lda, int* perm);
+
+// Right-looking blocked LuFactor: each panel is followed by a parallel
+// update of the whole trailing matrix, so all threads wait for the panel.
+template <typename T>
+int LuFactorBlocked(T* a, int n, int lda, int* perm);
+
+// LuFactor as a task graph of tile kernels (panel, row swaps and
+// triangular solve, trailing GEMM per tile) on S21TaskGraph: the next
+// panel starts as soon as its own column is updated, overlapping the rest
+// of the trailing update. Pivots are chosen as by LuFactorBlocked.
+template <typename T>
+int LuFactorTiled(T* a, int n, int lda, int* perm);
+
+// Overwrites the n x nrhs row-major matrix b with the solution of A X = B,
+// where lu and perm come from LuFactor.
+template <typename T>
+void LuSolve(const T* lu, int n, int ldlu, const int* perm, T* b, int nrhs,
+             int ldb);
+
+// LuFactor with full pivoting: row i of PAQ is row perm[i] of the original
+// matrix with its columns in the order col_perm. The pivots come out in
+// decreasing magnitude, which makes LuRank reliable. Unblocked, so slower
+// than LuFactor for large n. The sign covers both permutations.
+template <typename T>
+int LuFactorFull(T* a, int n, int lda, int* perm, int* col_perm);
+
+// max column sum of |a| for a rows x cols row-major matrix; T is double,
+// float or BFloat16
+template <typename T>
+double Norm1(const T* a, int rows, int cols, int lda);
+
+// Estimate of 1 / (||A||_1 ||A^-1||_1) from the factors of LuFactor or
+// LuFactorFull and norm = Norm1(A), by Hager's method as in LAPACK xGECON:
+// a few solves with A and A^T, O(n^2). 0 if a pivot is zero.
+template <typename T>
+double LuRcond(const T* lu, int n, int ldlu, const int* perm, double norm);
+
+// Pivots larger than n * epsilon times the largest one.
+template <typename T>
+int LuRank(const T* lu, int n, int ldlu);
+
+// True if a factorization in T with reciprocal condition number rcond is
+// singular to working precision. Unlike a threshold on |det|, this does not
+// change when the matrix is scaled.
+template <typename T>
+bool RcondSingular(double rcond, int n) noexcept {
+  const double epsilon = std::numeric_limits<T>::epsilon();
+  return !(rcond >= n * epsilon);
+}
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_LU_H_
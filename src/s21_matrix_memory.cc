@@ -0,0 +1,194 @@
+// created by pizpotli
+#include "s21_matrix_memory.h"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+
+constexpr std::size_t kAlignment = 64;
+
+// Size classes: 64, 80, 96, 112, 128, 160, ... 4 MiB.
+constexpr std::size_t kMinBlock = 64;
+constexpr int kMaxShift = 16;
+constexpr int kClasses = kMaxShift * 4 + 1;
+
+// A thread keeps up to this many bytes of free blocks per size class, but
+// always at least one and at most kCacheBlocks blocks.
+constexpr std::size_t kCacheBytes = 256 * 1024;
+constexpr std::size_t kCacheBlocks = 16;
+
+thread_local std::pmr::memory_resource* current_resource = nullptr;
+
+std::size_t ClassBytes(int size_class) {
+  return (kMinBlock << (size_class / 4)) / 4 * (4 + size_class % 4);
+}
+
+// Smallest class holding bytes, kClasses if the request is too large.
+int SizeClass(std::size_t bytes) {
+  if (bytes <= kMinBlock) {
+    return 0;
+  }
+  if (bytes > ClassBytes(kClasses - 1)) {
+    return kClasses;
+  }
+  const int log = 63 - __builtin_clzll(bytes - 1);
+  const std::size_t base = std::size_t{1} << log;
+  const int quarter = static_cast<int>(((bytes - base) * 4 + base - 1) / base);
+  return (log - 6) * 4 + quarter;
+}
+
+std::size_t CacheLimit(int size_class) {
+  return std::clamp<std::size_t>(kCacheBytes / ClassBytes(size_class), 1,
+                                 kCacheBlocks);
+}
+
+class AlignedNew : public std::pmr::memory_resource {
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return ::operator new[](
+        bytes, std::align_val_t{std::max(alignment, kAlignment)});
+  }
+  void do_deallocate(void* block, std::size_t,
+                     std::size_t alignment) override {
+    ::operator delete[](block,
+                        std::align_val_t{std::max(alignment, kAlignment)});
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+namespace s21 {
+
+std::pmr::memory_resource* AlignedNewResource() noexcept {
+  // never destroyed: matrices with static storage may outlive any local
+  static AlignedNew* resource = new AlignedNew;
+  return resource;
+}
+
+std::pmr::memory_resource* CurrentMatrixResource() noexcept {
+  return current_resource ? current_resource : AlignedNewResource();
+}
+
+}  // namespace s21
+
+// RESOURCE SCOPE
+
+S21MatrixResourceScope::S21MatrixResourceScope(
+    std::pmr::memory_resource* resource) noexcept
+    : previous_(current_resource) {
+  current_resource = resource;
+}
+
+S21MatrixResourceScope::~S21MatrixResourceScope() noexcept {
+  current_resource = previous_;
+}
+
+// POOL
+
+struct S21MatrixPool::ThreadCache {
+  std::vector<void*> free[kClasses];
+
+  ~ThreadCache() {
+    S21MatrixPool& pool = Instance();
+    std::lock_guard<std::mutex> lock(pool.mutex_);
+    for (int c = 0; c < kClasses; c++) {
+      pool.free_[c].insert(pool.free_[c].end(), free[c].begin(),
+                           free[c].end());
+    }
+  }
+
+  static ThreadCache& Get() {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+};
+
+S21MatrixPool::S21MatrixPool() : free_(kClasses), upstream_allocations_(0) {}
+
+S21MatrixPool& S21MatrixPool::Instance() {
+  // never destroyed: thread caches hand their blocks back on thread exit
+  static S21MatrixPool* pool = new S21MatrixPool;
+  return *pool;
+}
+
+void S21MatrixPool::Trim() {
+  std::pmr::memory_resource* upstream = s21::AlignedNewResource();
+  ThreadCache& cache = ThreadCache::Get();
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int c = 0; c < kClasses; c++) {
+    free_[c].insert(free_[c].end(), cache.free[c].begin(),
+                    cache.free[c].end());
+    cache.free[c].clear();
+    for (void* block : free_[c]) {
+      upstream->deallocate(block, ClassBytes(c), kAlignment);
+    }
+    free_[c].clear();
+    free_[c].shrink_to_fit();
+  }
+}
+
+std::size_t S21MatrixPool::GetUpstreamAllocations() const noexcept {
+  return upstream_allocations_.load(std::memory_order_relaxed);
+}
+
+void* S21MatrixPool::do_allocate(std::size_t bytes, std::size_t alignment) {
+  const int size_class = SizeClass(bytes);
+  if (size_class == kClasses || alignment > kAlignment) {
+    upstream_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return s21::AlignedNewResource()->allocate(bytes, alignment);
+  }
+  std::vector<void*>& cached = ThreadCache::Get().free[size_class];
+  if (cached.empty()) {
+    // refill half of the cache at once to amortize the lock
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<void*>& shared = free_[size_class];
+    const std::size_t take =
+        std::min(shared.size(), (CacheLimit(size_class) + 1) / 2);
+    cached.insert(cached.end(), shared.end() - take, shared.end());
+    shared.erase(shared.end() - take, shared.end());
+  }
+  if (cached.empty()) {
+    upstream_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return s21::AlignedNewResource()->allocate(ClassBytes(size_class),
+                                               kAlignment);
+  }
+  void* block = cached.back();
+  cached.pop_back();
+  return block;
+}
+
+void S21MatrixPool::do_deallocate(void* block, std::size_t bytes,
+                                  std::size_t alignment) {
+  const int size_class = SizeClass(bytes);
+  if (size_class == kClasses || alignment > kAlignment) {
+    s21::AlignedNewResource()->deallocate(block, bytes, alignment);
+    return;
+  }
+  std::vector<void*>& cached = ThreadCache::Get().free[size_class];
+  if (cached.size() < CacheLimit(size_class)) {
+    cached.push_back(block);
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_[size_class].push_back(block);
+  }
+}
+
+bool S21MatrixPool::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+// ARENA
+
+S21ScopedArena::S21ScopedArena(std::size_t initial_bytes)
+    : arena_(initial_bytes, s21::AlignedNewResource()), scope_(&arena_) {}
+
+void S21ScopedArena::Reset() { arena_.release(); }
+
+std::pmr::memory_resource* S21ScopedArena::GetResource() noexcept {
+  return &arena_;
+}
@@ -0,0 +1,93 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_MEMORY_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_MEMORY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+// Memory resources for S21Matrix buffers. A matrix keeps the resource it
+// was created with for its whole life; a matrix created without an
+// explicit resource takes s21::CurrentMatrixResource() of the creating
+// thread.
+
+namespace s21 {
+
+// ::operator new[] with 64-byte alignment, the resource used outside of
+// any S21MatrixResourceScope.
+std::pmr::memory_resource* AlignedNewResource() noexcept;
+
+// Innermost resource installed on the calling thread by an
+// S21MatrixResourceScope, AlignedNewResource() if there is none.
+std::pmr::memory_resource* CurrentMatrixResource() noexcept;
+
+}  // namespace s21
+
+// Makes resource the current one of the calling thread until destroyed.
+// Scopes nest; threads of S21ThreadPool are not affected.
+class S21MatrixResourceScope {
+ public:
+  explicit S21MatrixResourceScope(std::pmr::memory_resource* resource) noexcept;
+  S21MatrixResourceScope(const S21MatrixResourceScope&) = delete;
+  S21MatrixResourceScope& operator=(const S21MatrixResourceScope&) = delete;
+  ~S21MatrixResourceScope() noexcept;
+
+ private:
+  std::pmr::memory_resource* previous_;
+};
+
+// Process-wide pool of matrix buffers. Requests are rounded up to size
+// classes (four per power of two, 64 B to 4 MiB); freed blocks go to a
+// small cache of the freeing thread and from there to a shared free list,
+// so steady-state allocation of same-sized temporaries never reaches the
+// upstream AlignedNewResource(). Larger requests are passed through.
+class S21MatrixPool : public std::pmr::memory_resource {
+ public:
+  static S21MatrixPool& Instance();
+
+  // Returns the blocks on the shared free list and in the calling thread's
+  // cache to the upstream resource.
+  void Trim();
+  // Blocks obtained from the upstream resource so far.
+  std::size_t GetUpstreamAllocations() const noexcept;
+
+ private:
+  struct ThreadCache;
+
+  std::mutex mutex_;
+  std::vector<std::vector<void*>> free_;
+  std::atomic<std::size_t> upstream_allocations_;
+
+  S21MatrixPool();
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* block, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+};
+
+// Bump allocator that becomes the current resource for its lifetime:
+// every matrix created in the scope, temporaries included, is carved out of
+// a few large chunks and released at once by Reset() or the destructor.
+// Matrices created in the scope must not outlive it; assigning to a matrix
+// created outside copies into that matrix's own buffer.
+class S21ScopedArena {
+ public:
+  explicit S21ScopedArena(std::size_t initial_bytes = 1 << 20);
+  S21ScopedArena(const S21ScopedArena&) = delete;
+  S21ScopedArena& operator=(const S21ScopedArena&) = delete;
+
+  // Frees everything allocated since construction or the last Reset();
+  // no matrix created in between may be used afterwards.
+  void Reset();
+  std::pmr::memory_resource* GetResource() noexcept;
+
+ private:
+  std::pmr::monotonic_buffer_resource arena_;
+  S21MatrixResourceScope scope_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_MEMORY_H_
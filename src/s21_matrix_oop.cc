@@ -1,387 +1,761 @@
 // created by pizpotli
 #include "s21_matrix_oop.h"
 
-// KONSTRUCTORS
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_lu.h"
+#include "s21_matrix_memory.h"
+#include "s21_matrix_scalar.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_stats.h"
+#include "s21_matrix_strassen.h"
+#include "s21_matrix_transpose.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Element-wise work below this many elements stays on the calling thread.
+constexpr int kParallelElements = 1 << 16;
+
+// Source columns per parallel Transpose task.
+constexpr int kTransposeStrip = 128;
+
+// Narrow elements are widened in runs of this many on the stack.
+constexpr std::size_t kWidenRun = 256;
+
+template <typename T>
+const s21::simd::BasicKernels<s21::ComputeType<T>>& Kernels() noexcept {
+  return s21::simd::Active<s21::ComputeType<T>>();
+}
+
+// BFloat16 runs are converted with the SIMD helpers; a BFloat16 is its bit
+// pattern.
+static_assert(sizeof(s21::BFloat16) == sizeof(std::uint16_t));
+
+void Widen(const s21::BFloat16* src, float* dst, std::size_t n) noexcept {
+  s21::simd::WidenBf16(reinterpret_cast<const std::uint16_t*>(src), dst, n);
+}
+
+void Narrow(const float* src, s21::BFloat16* dst, std::size_t n) noexcept {
+  s21::simd::NarrowBf16(src, reinterpret_cast<std::uint16_t*>(dst), n);
+}
+
+// op(dst, src, n) on n elements of compute type; narrow storage is copied
+// to and from the stack one run at a time. src may be null.
+template <typename T, typename Op>
+void Apply(T* dst, const T* src, std::size_t n, Op op) {
+  if constexpr (s21::kWidened<T>) {
+    s21::ComputeType<T> d[kWidenRun], s[kWidenRun];
+    for (std::size_t i = 0; i < n; i += kWidenRun) {
+      const std::size_t m = std::min(kWidenRun, n - i);
+      Widen(dst + i, d, m);
+      if (src) Widen(src + i, s, m);
+      op(d, s, m);
+      Narrow(d, dst + i, m);
+    }
+  } else {
+    op(dst, src, n);
+  }
+}
 
-S21Matrix::S21Matrix() noexcept : rows_(0), cols_(0) { matrix_ = nullptr; }
+template <typename T>
+bool Equal(const T* a, const T* b, std::size_t n, double eps) {
+  using C = s21::ComputeType<T>;
+  const auto& k = Kernels<T>();
+  if constexpr (s21::kWidened<T>) {
+    C x[kWidenRun], y[kWidenRun];
+    for (std::size_t i = 0; i < n; i += kWidenRun) {
+      const std::size_t m = std::min(kWidenRun, n - i);
+      Widen(a + i, x, m);
+      Widen(b + i, y, m);
+      if (!k.equal(x, y, m, static_cast<C>(eps))) return false;
+    }
+    return true;
+  } else {
+    return k.equal(a, b, n, static_cast<C>(eps));
+  }
+}
 
-S21Matrix::S21Matrix(int rows, int cols) {
+// a is singular to the precision of C if its condition number, exact here
+// from the computed inverse, is too large; unlike a threshold on |det| this
+// does not depend on the scale of a.
+template <typename T, typename C>
+bool Singular(const S21BasicMatrix<T>& a, const S21BasicMatrix<C>& inverse) {
+  const int n = a.GetRows();
+  const double norm = s21::Norm1(a.data(), n, n, a.stride()) *
+                      s21::Norm1(inverse.data(), n, n, inverse.stride());
+  return s21::RcondSingular<C>(1 / norm, n);
+}
+
+}  // namespace
+
+// KONSTRUCTORS
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix() noexcept
+    : rows_(0),
+      cols_(0),
+      stride_(0),
+      matrix_(nullptr),
+      resource_(s21::CurrentMatrixResource()),
+      refs_(nullptr) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols)
+    : S21BasicMatrix(rows, cols, s21::CurrentMatrixResource()) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols,
+                                  std::pmr::memory_resource* resource)
+    : matrix_(nullptr), resource_(resource), refs_(nullptr) {
+  S21_STATS_SCOPE(kConstruct, 0);
   MallocMatrix(rows, cols);
   ZeroMatrix();
 }
 
-S21Matrix::S21Matrix(const S21Matrix& other) {
-  MallocMatrix(other.rows_, other.cols_);
-  CopyMatrix(other);
+// like std::pmr containers, a copy does not inherit the resource
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix& other)
+    : S21BasicMatrix() {
+  S21_STATS_SCOPE(kCopyConstruct, 0);
+  if (!Share(other)) {
+    MallocMatrix(other.rows_, other.cols_);
+    CopyMatrix(other);
+    SetCopyOnWrite(other.refs_ != nullptr);
+  }
 }
 
-S21Matrix::S21Matrix(S21Matrix&& other) noexcept
-    : rows_(other.rows_), cols_(other.cols_) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      resource_(other.resource_) {
+  S21_STATS_SCOPE(kMoveConstruct, 0);
   if (this != &other) {
     matrix_ = other.matrix_;
+    refs_ = other.refs_;
     other.matrix_ = nullptr;
+    other.refs_ = nullptr;
     other.rows_ = 0;
     other.cols_ = 0;
+    other.stride_ = 0;
   }
 }
 
 // DESTRUCTOR
 
-S21Matrix::~S21Matrix() noexcept { Remove(); }
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() noexcept { Remove(); }
 
 // ARITHMETICS
 
-void S21Matrix::SumMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix& other) {
+  S21_STATS_SCOPE(kSumMatrix, static_cast<std::uint64_t>(rows_) * cols_);
   CheckMistakes(other, 1);
   CheckMistakes(other, 2);
-  for (int i = 0; i < other.rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      matrix_[i][j] += other.matrix_[i][j];
-    }
-  }
-}
-
-bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
+  Detach();
+  ForRows([&](int begin, int end) {
+    Apply(RowData(begin), other.RowData(begin),
+          static_cast<std::size_t>(end - begin) * stride_,
+          [](auto* dst, const auto* src, std::size_t n) {
+            Kernels<T>().add(dst, src, n);
+          });
+  });
+}
+
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix& other) const
+    noexcept {
+  S21_STATS_SCOPE(kEqMatrix, static_cast<std::uint64_t>(rows_) * cols_);
   bool result = true;
-  if (rows_ == other.rows_ && cols_ == other.cols_) {
-    for (int i = 0; i < rows_ && result == true; i++) {
-      for (int j = 0; j < cols_ && result == true; j++) {
-        if (fabs(matrix_[i][j] - other.matrix_[i][j]) > 1e-6) {
-          result = false;
-        }
-      }
-    }
+  if (rows_ == other.rows_ && cols_ == other.cols_ &&
+      matrix_ == other.matrix_) {
+    result = true;
+  } else if (rows_ == other.rows_ && cols_ == other.cols_) {
+    result = Equal(matrix_, other.matrix_, Size(),
+                   s21::ScalarTraits<T>::kEpsilon);
   } else {
     result = false;
   }
   return result;
 }
 
-void S21Matrix::SubMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix& other) {
+  S21_STATS_SCOPE(kSubMatrix, static_cast<std::uint64_t>(rows_) * cols_);
   CheckMistakes(other, 1);
   CheckMistakes(other, 2);
-  for (int i = 0; i < other.rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      matrix_[i][j] -= other.matrix_[i][j];
-    }
-  }
-}
-
-void S21Matrix::MulNumber(const double num) {
+  Detach();
+  ForRows([&](int begin, int end) {
+    Apply(RowData(begin), other.RowData(begin),
+          static_cast<std::size_t>(end - begin) * stride_,
+          [](auto* dst, const auto* src, std::size_t n) {
+            Kernels<T>().sub(dst, src, n);
+          });
+  });
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const double num) {
+  S21_STATS_SCOPE(kMulNumber, static_cast<std::uint64_t>(rows_) * cols_);
   CheckMistakes2(1);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] *= num;
-    }
+  Detach();
+  const s21::ComputeType<T> factor = static_cast<s21::ComputeType<T>>(num);
+  ForRows([&](int begin, int end) {
+    Apply(RowData(begin), static_cast<const T*>(nullptr),
+          static_cast<std::size_t>(end - begin) * stride_,
+          [factor](auto* dst, const auto*, std::size_t n) {
+            Kernels<T>().scale(dst, factor, n);
+          });
+  });
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix& other) {
+  *this = *this * other;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MulMatrixStrassen(const S21BasicMatrix& other) {
+  if constexpr (s21::kWidened<T>) {
+    MulMatrix(other);
+  } else {
+    S21_STATS_SCOPE(kMulMatrixStrassen,
+                    2 * static_cast<std::uint64_t>(rows_) * cols_ *
+                        other.cols_);
+    CheckMistakes(other, 1);
+    CheckMistakes(other, 3);
+    const std::size_t size =
+        s21::StrassenWorkspace(rows_, other.cols_, cols_);
+    // every element is written below, no need to zero; the workspace comes
+    // from the current resource like any buffer, so a pool or an arena
+    // serves it too
+    S21BasicMatrix res, work;
+    res.MallocMatrix(rows_, other.cols_);
+    work.MallocMatrix(1, static_cast<int>(std::max<std::size_t>(size, 1)));
+    s21::StrassenGemm(rows_, other.cols_, cols_, matrix_, stride_,
+                      other.matrix_, other.stride_, res.matrix_, res.stride_,
+                      work.matrix_);
+    *this = std::move(res);
   }
 }
 
-void S21Matrix::MulMatrix(const S21Matrix& other) {
-  CheckMistakes(other, 1);
-  CheckMistakes(other, 3);
-  S21Matrix tmp(rows_, cols_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      double res = 0;
-      for (int k = 0; k < cols_; k++) {
-        res += matrix_[i][k] * other.matrix_[k][j];
-      }
-      tmp.matrix_[i][j] = res;
-    }
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() const {
+  S21_STATS_SCOPE(kTranspose, 0);
+  CheckMistakes2(1);
+  // every element is written below, no need to zero
+  S21BasicMatrix tmp;
+  tmp.MallocMatrix(cols_, rows_);
+  // each task takes a strip of source columns, i.e. destination rows
+  const int strips = (cols_ + kTransposeStrip - 1) / kTransposeStrip;
+  auto body = [&](int begin, int end) {
+    const int j0 = begin * kTransposeStrip;
+    const int j1 = std::min(end * kTransposeStrip, cols_);
+    s21::TransposeCopy(matrix_ + j0, rows_, j1 - j0, stride_, tmp.RowData(j0),
+                       tmp.stride_);
+  };
+  if (Size() < kParallelElements) {
+    body(0, strips);
+  } else {
+    S21ThreadPool::Global().ParallelFor(strips, 1, body);
   }
-  *this = tmp;
-  tmp.Remove();
+  return tmp;
 }
 
-S21Matrix S21Matrix::Transpose() const {
+template <typename T>
+void S21BasicMatrix<T>::TransposeInPlace() {
+  S21_STATS_SCOPE(kTransposeInPlace, 0);
   CheckMistakes2(1);
-  S21Matrix tmp(cols_, rows_);
-  for (int i = 0; i < tmp.rows_; i++) {
-    for (int j = 0; j < tmp.cols_; j++) {
-      tmp(i, j) = matrix_[j][i];
-    }
+  Detach();
+  if (rows_ == cols_) {
+    s21::TransposeSquare(matrix_, rows_, stride_);
+  } else {
+    s21::TransposeInPlace(matrix_, rows_, cols_);
+    std::swap(rows_, cols_);
+    stride_ = cols_;
   }
-  return tmp;
 }
 
-S21Matrix S21Matrix::CalcComplements() const {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() const {
+  // LU and a solve for n right-hand sides, det * A^-1 being M^T
+  S21_STATS_SCOPE(kCalcComplements,
+                  2 * static_cast<std::uint64_t>(rows_) * rows_ * rows_);
   CheckMistakes2(1);
   CheckMistakes2(2);
-  S21Matrix result(*this);
-  S21Matrix minor(*this);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      S21Matrix tmp(rows_ - 1, cols_ - 1);
-      minor.Minor(i, j, tmp);
-      double det = 0;
-      det = tmp.Determinant();
-      result.matrix_[i][j] = pow(-1.0, i + j) * det;
-      tmp.Remove();
+  S21BasicMatrix result(rows_, cols_);
+  if (rows_ == 1) {
+    result.matrix_[0] = 1;
+    return result;
+  }
+  S21BasicMatrix<s21::ComputeType<T>> lu;
+  std::vector<int> perm(rows_);
+  const int sign = Triangulate(lu, perm.data());
+  double det = sign;
+  for (int x = 0; x < rows_; x++) {
+    det *= lu.RowData(x)[x];
+  }
+  S21BasicMatrix<s21::ComputeType<T>> inverse(rows_, cols_);
+  if (sign != 0) {
+    inverse.Identity();
+    s21::LuSolve(lu.matrix_, rows_, lu.stride_, perm.data(), inverse.matrix_,
+                 cols_, inverse.stride_);
+  }
+  if (sign != 0 && !Singular(*this, inverse)) {
+    // M^T = det * A^-1
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        result.RowData(i)[j] = det * inverse.RowData(j)[i];
+      }
+    }
+  } else {
+    S21BasicMatrix minor(rows_ - 1, cols_ - 1);
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        Minor(i, j, minor);
+        result.RowData(i)[j] = ((i + j) % 2 ? -1 : 1) * minor.Determinant();
+      }
     }
   }
-  minor.Remove();
   return result;
 }
 
-S21Matrix S21Matrix::InverseMatrix() const {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() const {
+  S21_STATS_SCOPE(kInverseMatrix,
+                  2 * static_cast<std::uint64_t>(rows_) * rows_ * rows_);
   CheckMistakes2(1);
-  double det = 0;
-  S21Matrix tmp(*this);
-  det = this->Determinant();
-  if (fabs(det) < 1e-7) {
-    tmp.Remove();
+  CheckMistakes2(2);
+  S21BasicMatrix<s21::ComputeType<T>> lu;
+  std::vector<int> perm(rows_);
+  const int sign = Triangulate(lu, perm.data());
+  S21BasicMatrix<s21::ComputeType<T>> tmp(rows_, cols_);
+  if (sign != 0) {
+    tmp.Identity();
+    s21::LuSolve(lu.matrix_, rows_, lu.stride_, perm.data(), tmp.matrix_,
+                 cols_, tmp.stride_);
+  }
+  if (sign == 0 || Singular(*this, tmp)) {
     throw std::out_of_range("ERROR: calculation impossible: Determinant = 0");
+  }
+  if constexpr (s21::kWidened<T>) {
+    return S21BasicMatrix(tmp);
   } else {
-    if (rows_ > 1 && cols_ > 1) {
-      S21Matrix tmp2 = tmp.CalcComplements();
-      S21Matrix transpon = tmp2.Transpose();
-      transpon.MulNumber(1.0 / det);
-      tmp.CopyMatrix(transpon);
-      transpon.Remove();
-      tmp2.Remove();
-    } else {
-      S21Matrix tmp2(1, 1);
-      tmp.matrix_[0][0] = 1.0 / matrix_[0][0];
-    }
+    return tmp;
   }
-  return tmp;
 }
 
-double S21Matrix::Determinant() const {
+template <typename T>
+double S21BasicMatrix<T>::Determinant() const {
+  S21_STATS_SCOPE(kDeterminant,
+                  2 * static_cast<std::uint64_t>(rows_) * rows_ * rows_ / 3);
   CheckMistakes2(1);
   CheckMistakes2(2);
-  double res = 0;
-  S21Matrix tmp;
-  S21Matrix copy(*this);
-  res = (-copy.Triangulate(tmp) % 2) ? -1 : 1;
-  for (int x = 0; x < tmp.cols_; x++) {
-    res *= tmp.matrix_[x][x];
+  S21BasicMatrix<s21::ComputeType<T>> lu;
+  std::vector<int> perm(rows_);
+  double res = Triangulate(lu, perm.data());
+  for (int x = 0; x < rows_; x++) {
+    res *= lu.RowData(x)[x];
   }
-  tmp.Remove();
-  copy.Remove();
-  return -res;
+  return res;
 }
 
 // OPERATORS
 
-S21Matrix S21Matrix::operator+(const S21Matrix& other) const {
-  S21Matrix res(*this);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator+(
+    const S21BasicMatrix& other) const {
+  S21BasicMatrix res(*this);
   res.SumMatrix(other);
   return res;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix& other) const {
-  S21Matrix res(*this);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator-(
+    const S21BasicMatrix& other) const {
+  S21BasicMatrix res(*this);
   res.SubMatrix(other);
   return res;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix& other) const {
-  S21Matrix res(*this);
-  res.MulMatrix(other);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(
+    const S21BasicMatrix& other) const {
+  S21_STATS_SCOPE(kMulMatrix, 2 * static_cast<std::uint64_t>(rows_) *
+                                  cols_ * other.cols_);
+  CheckMistakes(other, 1);
+  CheckMistakes(other, 3);
+  S21BasicMatrix res(rows_, other.cols_);
+  s21::GemmTiled(rows_, other.cols_, cols_, 1.0, matrix_, stride_, 1,
+                 other.matrix_, other.stride_, 1, res.matrix_, res.stride_);
   return res;
 }
 
-S21Matrix S21Matrix::operator*(const double number) const {
-  S21Matrix res(*this);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(const double number) const {
+  S21BasicMatrix res(*this);
   res.MulNumber(number);
   return res;
 }
 
-S21Matrix operator*(const double number, const S21Matrix& other) {
-  S21Matrix tmp(other);
-  return tmp *= number;
-}
-
-S21Matrix& S21Matrix::operator+=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(const S21BasicMatrix& other) {
   SumMatrix(other);
   return *this;
 }
 
-S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(const S21BasicMatrix& other) {
   SubMatrix(other);
   return *this;
 }
 
-S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const S21BasicMatrix& other) {
   MulMatrix(other);
   return *this;
 }
 
-S21Matrix& S21Matrix::operator*=(const double number) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const double number) {
   MulNumber(number);
   return *this;
 }
 
-bool S21Matrix::operator==(const S21Matrix& other) const {
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix& other) const {
   bool res = EqMatrix(other);
   return res;
 }
 
-S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
-  CopyMatrix(other);
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(const S21BasicMatrix& other) {
+  S21_STATS_SCOPE(kCopyAssign, 0);
+  if (this != &other && !Share(other)) {
+    CopyMatrix(other);
+    SetCopyOnWrite(other.refs_ != nullptr);
+  }
+  return *this;
+}
+
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(S21BasicMatrix&& other) {
+  S21_STATS_SCOPE(kMoveAssign, 0);
+  if (this != &other && !resource_->is_equal(*other.resource_)) {
+    // the buffer cannot change hands between resources
+    CopyMatrix(other);
+    SetCopyOnWrite(other.refs_ != nullptr);
+  } else if (this != &other) {
+    Remove();
+    std::swap(rows_, other.rows_);
+    std::swap(cols_, other.cols_);
+    std::swap(stride_, other.stride_);
+    std::swap(matrix_, other.matrix_);
+    std::swap(resource_, other.resource_);
+    std::swap(refs_, other.refs_);
+  }
   return *this;
 }
 
-double& S21Matrix::operator()(const int x, const int y) {
+template <typename T>
+T& S21BasicMatrix<T>::operator()(const int x, const int y) {
+  if (x >= rows_ || y >= cols_ || x < 0 || y < 0) {
+    throw std::out_of_range("ERROR: index outside matrix");
+  }
+  // the detaching path is out of line, so this one needs no stack frame
+  if (refs_ != nullptr && refs_->load(std::memory_order_acquire) > 1) {
+    return DetachAt(x, y);
+  }
+  return matrix_[static_cast<std::ptrdiff_t>(x) * stride_ + y];
+}
+
+template <typename T>
+const T& S21BasicMatrix<T>::operator()(const int x, const int y) const {
   if (x >= rows_ || y >= cols_ || x < 0 || y < 0) {
     throw std::out_of_range("ERROR: index outside matrix");
   }
-  return matrix_[x][y];
+  return matrix_[static_cast<std::ptrdiff_t>(x) * stride_ + y];
 }
 
 // ACCESSORS
 
-int S21Matrix::GetRows() const noexcept { return rows_; }
+template <typename T>
+std::pmr::memory_resource* S21BasicMatrix<T>::GetResource() const noexcept {
+  return resource_;
+}
 
-int S21Matrix::GetCols() const noexcept { return cols_; }
+template <typename T>
+bool S21BasicMatrix<T>::GetCopyOnWrite() const noexcept {
+  return refs_ != nullptr;
+}
 
 // MUTATORS
 
-void S21Matrix::SetRows(const int rows) {
+template <typename T>
+void S21BasicMatrix<T>::SetRows(const int rows) {
+  S21_STATS_SCOPE(kSetRows, 0);
   if (rows < 1) {
     throw std::out_of_range("ERROR: incorrect matrix");
   }
-  S21Matrix A;
+  S21BasicMatrix A;
+  A.resource_ = resource_;
   A.MallocMatrix(rows, cols_);
-  A.ZeroMatrix();
-  int a = 0;
-  if (A.rows_ < rows_) {
-    a = A.rows_;
-  } else {
-    a = rows_;
-  }
+  int a = std::min(A.rows_, rows_);
+  S21_STATS_COPIED(sizeof(T) * a * cols_);
   for (int i = 0; i < a; i++) {
-    for (int j = 0; j < A.cols_; j++) {
-      A.matrix_[i][j] = matrix_[i][j];
-    }
+    std::memcpy(A.RowData(i), RowData(i), sizeof(T) * cols_);
   }
-  CopyMatrix(A);
-  A.Remove();
+  for (int i = a; i < A.rows_; i++) {
+    std::fill_n(A.RowData(i), A.cols_, T(0));
+  }
+  A.SetCopyOnWrite(refs_ != nullptr);
+  std::swap(rows_, A.rows_);
+  std::swap(stride_, A.stride_);
+  std::swap(matrix_, A.matrix_);
+  std::swap(refs_, A.refs_);
 }
 
-void S21Matrix::SetCols(const int cols) {
+template <typename T>
+void S21BasicMatrix<T>::SetCols(const int cols) {
+  S21_STATS_SCOPE(kSetCols, 0);
   if (cols < 1) {
     throw std::out_of_range("ERROR: incorrect matrix");
   }
-  S21Matrix A;
+  S21BasicMatrix A;
+  A.resource_ = resource_;
   A.MallocMatrix(rows_, cols);
-  A.ZeroMatrix();
-  int a = 0;
-  if (A.cols_ < cols_) {
-    a = A.cols_;
-  } else {
-    a = cols_;
-  }
+  int a = std::min(A.cols_, cols_);
+  S21_STATS_COPIED(sizeof(T) * a * rows_);
   for (int i = 0; i < A.rows_; i++) {
-    for (int j = 0; j < a; j++) {
-      A.matrix_[i][j] = matrix_[i][j];
-    }
+    T* dst = A.RowData(i);
+    std::memcpy(dst, RowData(i), sizeof(T) * a);
+    std::fill(dst + a, dst + A.cols_, T(0));
+  }
+  A.SetCopyOnWrite(refs_ != nullptr);
+  std::swap(cols_, A.cols_);
+  std::swap(stride_, A.stride_);
+  std::swap(matrix_, A.matrix_);
+  std::swap(refs_, A.refs_);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::SetCopyOnWrite(const bool on) {
+  if (on && refs_ == nullptr) {
+    CheckMistakes2(1);
+    refs_ = NewRefs();
+  } else if (!on && refs_ != nullptr) {
+    Detach();
+    FreeRefs();
   }
-  CopyMatrix(A);
-  A.Remove();
 }
 
 // HELP FUNCTIONS
 
-void S21Matrix::Remove() noexcept {
-  if (matrix_) {
-    for (int i = 0; i < rows_; i++) {
-      if (matrix_[i]) {
-        delete [] matrix_[i];
-      }
+template <typename T>
+T* S21BasicMatrix<T>::Allocate(std::size_t count) {
+  S21_STATS_ALLOCATED(count * sizeof(T));
+  return static_cast<T*>(
+      resource_->allocate(count * sizeof(T), kAlignment));
+}
+
+template <typename T>
+void S21BasicMatrix<T>::Deallocate(T* buffer, std::size_t count) noexcept {
+  resource_->deallocate(buffer, count * sizeof(T), kAlignment);
+}
+
+template <typename T>
+T* S21BasicMatrix<T>::RowData(int i) noexcept {
+  return matrix_ + static_cast<std::size_t>(i) * stride_;
+}
+
+template <typename T>
+const T* S21BasicMatrix<T>::RowData(int i) const noexcept {
+  return matrix_ + static_cast<std::size_t>(i) * stride_;
+}
+
+template <typename T>
+std::size_t S21BasicMatrix<T>::Size() const noexcept {
+  return static_cast<std::size_t>(rows_) * stride_;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::Remove() noexcept {
+  if (refs_ != nullptr) {
+    if (refs_->fetch_sub(1, std::memory_order_acq_rel) > 1) {
+      // the other owners keep the buffer and the count
+      matrix_ = nullptr;
+      refs_ = nullptr;
+    } else {
+      FreeRefs();
     }
-    delete [] matrix_;
+  }
+  if (matrix_) {
+    Deallocate(matrix_, Size());
     matrix_ = nullptr;
   }
   rows_ = 0;
   cols_ = 0;
+  stride_ = 0;
+}
+
+// the count lives in a block of its own from the same resource, so a
+// matrix that is not copy-on-write pays nothing for it
+template <typename T>
+std::atomic<int>* S21BasicMatrix<T>::NewRefs() {
+  void* block = resource_->allocate(sizeof(std::atomic<int>),
+                                    alignof(std::atomic<int>));
+  return new (block) std::atomic<int>(1);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::FreeRefs() noexcept {
+  refs_->~atomic();
+  resource_->deallocate(refs_, sizeof(std::atomic<int>),
+                        alignof(std::atomic<int>));
+  refs_ = nullptr;
 }
 
-void S21Matrix::MallocMatrix(int x, int y) {
+// takes a reference to the buffer of a copy-on-write matrix; false if
+// other is not one or the buffer came from a resource unlike this one's
+template <typename T>
+bool S21BasicMatrix<T>::Share(const S21BasicMatrix& other) {
+  if (other.refs_ == nullptr || !resource_->is_equal(*other.resource_)) {
+    return false;
+  }
+  if (matrix_ != other.matrix_) {
+    other.refs_->fetch_add(1, std::memory_order_relaxed);
+    Remove();
+    matrix_ = other.matrix_;
+    refs_ = other.refs_;
+  }
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  stride_ = other.stride_;
+  return true;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::DetachBuffer() {
+  S21_STATS_SCOPE(kDetach, 0);
+  S21BasicMatrix own;
+  own.resource_ = resource_;
+  own.MallocMatrix(rows_, cols_);
+  own.CopyMatrix(*this);
+  own.refs_ = own.NewRefs();
+  // own leaves with the reference to the shared buffer
+  std::swap(matrix_, own.matrix_);
+  std::swap(refs_, own.refs_);
+}
+
+template <typename T>
+T& S21BasicMatrix<T>::DetachAt(int x, int y) {
+  DetachBuffer();
+  return matrix_[static_cast<std::ptrdiff_t>(x) * stride_ + y];
+}
+
+template <typename T>
+void S21BasicMatrix<T>::MallocMatrix(int x, int y) {
+  S21_STATS_SCOPE(kMallocMatrix, 0);
   if (x < 1 || y < 1) {
     throw std::out_of_range("ERROR: incorrect matrix");
   }
-  matrix_ = new double*[x]();
-  for (int i = 0; i < x; i++) {
-    matrix_[i] = new double[y]();
-  }
+  matrix_ = Allocate(static_cast<std::size_t>(x) * y);
   rows_ = x;
   cols_ = y;
+  stride_ = y;
 }
 
-void S21Matrix::SumStr(int row, int ro, double tmp) noexcept {
-  for (int x = 0; x < cols_; x++) matrix_[row][x] += matrix_[ro][x] * tmp;
-}
-
-void S21Matrix::Minor(int x, int y, S21Matrix& other) noexcept {
-  int i1 = 0, i2 = 0, j1 = 0, j2 = 0;
-  for (i1 = 0; i1 < rows_ - 1; i1++) {
+template <typename T>
+void S21BasicMatrix<T>::Minor(int x, int y, S21BasicMatrix& other) const
+    noexcept {
+  S21_STATS_SCOPE(kMinor, 0);
+  S21_STATS_COPIED(sizeof(T) * (rows_ - 1) * (cols_ - 1));
+  for (int i1 = 0, i2 = 0; i1 < rows_ - 1; i1++) {
     if (i1 == x) {
       i2 = 1;
     }
-    j2 = 0;
-    for (j1 = 0; j1 < rows_ - 1; j1++) {
-      if (j1 == y) {
-        j2 = 1;
-      }
-      other.matrix_[i1][j1] = matrix_[i1 + i2][j1 + j2];
-    }
+    const T* src = RowData(i1 + i2);
+    T* dst = other.RowData(i1);
+    std::memcpy(dst, src, sizeof(T) * y);
+    std::memcpy(dst + y, src + y + 1, sizeof(T) * (cols_ - 1 - y));
   }
 }
 
-void S21Matrix::CopyMatrix(const S21Matrix& other) noexcept {
-  for (int i = 0; i < rows_; i++) {
-    delete (matrix_[i]);
+template <typename T>
+void S21BasicMatrix<T>::CopyMatrix(const S21BasicMatrix& other) {
+  if (this == &other) {
+    return;
   }
-  delete (matrix_);
-  matrix_ = new double*[other.rows_]();
-  for (int i = 0; i < other.rows_; i++) {
-    matrix_[i] = new double[other.cols_]();
+  S21_STATS_SCOPE(kCopyMatrix, 0);
+  S21_STATS_COPIED(sizeof(T) * other.rows_ * other.cols_);
+  if (refs_ != nullptr && refs_->load(std::memory_order_acquire) > 1) {
+    // not into a buffer the other owners still read
+    Remove();
+  }
+  if (static_cast<std::size_t>(rows_) * cols_ !=
+      static_cast<std::size_t>(other.rows_) * other.cols_) {
+    Remove();
+    if (other.matrix_) {
+      matrix_ = Allocate(static_cast<std::size_t>(other.rows_) * other.cols_);
+    }
   }
   rows_ = other.rows_;
   cols_ = other.cols_;
-  for (int i = 0; i < other.rows_; i++) {
-    for (int j = 0; j < other.cols_; j++) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
+  stride_ = cols_;
+  for (int i = 0; i < rows_; i++) {
+    std::memcpy(RowData(i), other.RowData(i), sizeof(T) * cols_);
   }
 }
 
-void S21Matrix::ZeroMatrix() noexcept {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = 0;
-    }
+template <typename T>
+void S21BasicMatrix<T>::ZeroMatrix() noexcept {
+  std::fill_n(matrix_, Size(), T(0));
+}
+
+template <typename T>
+template <typename F>
+void S21BasicMatrix<T>::ForRows(F&& body) {
+  if (Size() < kParallelElements) {
+    body(0, rows_);
+  } else {
+    const int grain = std::max(1, kParallelElements / 4 / stride_);
+    S21ThreadPool::Global().ParallelFor(rows_, grain, body);
   }
 }
 
-int S21Matrix::Sdvig(int i, int j) noexcept {
-  double* tmp = matrix_[i];
-  matrix_[i] = matrix_[j];
-  matrix_[j] = tmp;
-  return -1;
+template <typename T>
+void S21BasicMatrix<T>::Identity() noexcept {
+  ZeroMatrix();
+  for (int i = 0; i < std::min(rows_, cols_); i++) {
+    RowData(i)[i] = 1;
+  }
 }
 
-int S21Matrix::Triangulate(S21Matrix& other) noexcept {
-  int znak = 1;
-  other.CopyMatrix(*this);
-  for (int i = 0; i < other.cols_; i++) {
-    if (!other.matrix_[i][i]) {
-      for (int j = i + 1; j < other.rows_; j++) {
-        if (other.matrix_[j][i]) {
-          znak -= other.Sdvig(j, i);
-        }
-      }
-    }
-    for (int j = i + 1; j < rows_; j++) {
-      other.SumStr(j, i, -other.matrix_[j][i] / other.matrix_[i][i]);
-    }
+template <typename T>
+int S21BasicMatrix<T>::Triangulate(S21BasicMatrix<s21::ComputeType<T>>& lu,
+                                   int* perm) const {
+  S21_STATS_SCOPE(kTriangulate,
+                  2 * static_cast<std::uint64_t>(rows_) * rows_ * rows_ / 3);
+  if constexpr (s21::kWidened<T>) {
+    lu = S21BasicMatrix<s21::ComputeType<T>>(*this);
+  } else {
+    lu.CopyMatrix(*this);
   }
-  return -znak;
+  return s21::LuFactor(lu.matrix_, lu.rows_, lu.stride_, perm);
 }
 
-void S21Matrix::CheckMistakes(const S21Matrix& other, const int number) const {
+template <typename T>
+void S21BasicMatrix<T>::CheckMistakes(const S21BasicMatrix& other,
+                                      const int number) const {
   if (number == 1) {
     if (rows_ < 1 || cols_ < 1 || other.rows_ < 1 || other.cols_ < 1) {
       throw std::out_of_range("ERROR: incorrect matrix");
@@ -397,7 +771,8 @@ void S21Matrix::CheckMistakes(const S21Matrix& other, const int number) const {
   }
 }
 
-void S21Matrix::CheckMistakes2(const int number) const {
+template <typename T>
+void S21BasicMatrix<T>::CheckMistakes2(const int number) const {
   if (number == 1) {
     if (rows_ < 1 || cols_ < 1) {
       throw std::out_of_range("ERROR: incorrect matrix");
@@ -408,3 +783,7 @@ void S21Matrix::CheckMistakes2(const int number) const {
     }
   }
 }
+
+template class S21BasicMatrix<double>;
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<s21::BFloat16>;
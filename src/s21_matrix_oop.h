@@ -2,79 +2,490 @@
 #ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_OOP_H_
 #define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_OOP_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
 
-class S21Matrix {
+#include "s21_matrix_scalar.h"
+
+namespace s21 {
+template <typename E>
+class MatrixExpr;
+
+// One row of a matrix as a range of size() contiguous elements; E is T
+// or const T.
+template <typename E>
+class MatrixRow {
+ public:
+  using value_type = std::remove_const_t<E>;
+  using iterator = E*;
+
+  MatrixRow(E* data, int size) noexcept : data_(data), size_(size) {}
+
+  E* begin() const noexcept { return data_; }
+  E* end() const noexcept { return data_ + size_; }
+  int size() const noexcept { return size_; }
+  E& operator[](const int j) const noexcept { return data_[j]; }
+
+ private:
+  E* data_;
+  int size_;
+};
+
+// Random access iterator over the rows of a matrix, dereferencing to a
+// MatrixRow by value.
+template <typename E>
+class MatrixRowIterator {
  public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = MatrixRow<E>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = MatrixRow<E>;
+
+  MatrixRowIterator() noexcept : MatrixRowIterator(nullptr, 0, 0) {}
+  MatrixRowIterator(E* row, int cols, int stride) noexcept
+      : row_(row), cols_(cols), stride_(stride) {}
+
+  reference operator*() const noexcept { return {row_, cols_}; }
+  reference operator[](difference_type n) const noexcept {
+    return *(*this + n);
+  }
+
+  MatrixRowIterator& operator++() noexcept { return *this += 1; }
+  MatrixRowIterator& operator--() noexcept { return *this -= 1; }
+  MatrixRowIterator operator++(int) noexcept {
+    MatrixRowIterator old = *this;
+    ++*this;
+    return old;
+  }
+  MatrixRowIterator operator--(int) noexcept {
+    MatrixRowIterator old = *this;
+    --*this;
+    return old;
+  }
+  MatrixRowIterator& operator+=(difference_type n) noexcept {
+    row_ += n * stride_;
+    return *this;
+  }
+  MatrixRowIterator& operator-=(difference_type n) noexcept {
+    row_ -= n * stride_;
+    return *this;
+  }
+  MatrixRowIterator operator+(difference_type n) const noexcept {
+    return MatrixRowIterator(*this) += n;
+  }
+  friend MatrixRowIterator operator+(difference_type n,
+                                     const MatrixRowIterator& it) noexcept {
+    return it + n;
+  }
+  MatrixRowIterator operator-(difference_type n) const noexcept {
+    return MatrixRowIterator(*this) -= n;
+  }
+  difference_type operator-(const MatrixRowIterator& other) const noexcept {
+    return stride_ ? (row_ - other.row_) / stride_ : 0;
+  }
+
+  bool operator==(const MatrixRowIterator& o) const noexcept {
+    return row_ == o.row_;
+  }
+  bool operator!=(const MatrixRowIterator& o) const noexcept {
+    return row_ != o.row_;
+  }
+  bool operator<(const MatrixRowIterator& o) const noexcept {
+    return row_ < o.row_;
+  }
+  bool operator>(const MatrixRowIterator& o) const noexcept {
+    return row_ > o.row_;
+  }
+  bool operator<=(const MatrixRowIterator& o) const noexcept {
+    return row_ <= o.row_;
+  }
+  bool operator>=(const MatrixRowIterator& o) const noexcept {
+    return row_ >= o.row_;
+  }
+
+ private:
+  E* row_;
+  int cols_, stride_;
+};
+
+// The rows of a matrix, for range-for
+template <typename E>
+class MatrixRows {
+ public:
+  MatrixRows(E* data, int rows, int cols, int stride) noexcept
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+  MatrixRowIterator<E> begin() const noexcept {
+    return {data_, cols_, stride_};
+  }
+  MatrixRowIterator<E> end() const noexcept {
+    return {data_ + static_cast<std::ptrdiff_t>(rows_) * stride_, cols_,
+            stride_};
+  }
+  int size() const noexcept { return rows_; }
+
+ private:
+  E* data_;
+  int rows_, cols_, stride_;
+};
+}  // namespace s21
+
+// Dense row-major matrix of T: double, float or s21::BFloat16. Narrow
+// element types are widened to s21::ComputeType<T> for arithmetic, so
+// BFloat16 storage halves the memory traffic of float while products
+// still accumulate in float. Numbers and determinants are double for
+// every T.
+//
+// Copy-on-write is opt-in per matrix: after SetCopyOnWrite(true), copies
+// take a reference to the buffer instead of a deep copy, and the mode
+// travels with the value to copies and assignees. A matrix gets a buffer
+// of its own on the first non-const access while others share it:
+// operator(), At, UncheckedAt, data(), begin(), end(), Rows() and every
+// mutator. Read through a const matrix (std::as_const, cbegin) to keep
+// sharing. The reference count is atomic, so copies may be used and
+// detached on different threads; a pointer or iterator obtained for
+// writing must not be used after the matrix was copied. Only copies under
+// an equal memory resource share.
+template <typename T>
+class S21BasicMatrix {
+ public:
+  using value_type = T;
+  // elements in row-major order; the storage is contiguous
+  using iterator = T*;
+  using const_iterator = const T*;
+
   // Konstructors
 
-  S21Matrix() noexcept;
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other) noexcept;
+  S21BasicMatrix() noexcept;
+  S21BasicMatrix(int rows, int cols);
+  // buffer from resource instead of s21::CurrentMatrixResource(), see
+  // s21_matrix_memory.h
+  S21BasicMatrix(int rows, int cols, std::pmr::memory_resource* resource);
+  S21BasicMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix(S21BasicMatrix&& other) noexcept;
+  // element-wise conversion, rounding to nearest
+  template <typename U>
+  explicit S21BasicMatrix(const S21BasicMatrix<U>& other);
+  // fused evaluation of a lazy expression, see s21_matrix_expr.h; double
+  // matrices only
+  template <typename E>
+  explicit S21BasicMatrix(const s21::MatrixExpr<E>& expr);
 
   // Destructor
 
-  ~S21Matrix() noexcept;
+  ~S21BasicMatrix() noexcept;
 
   // Arithmetics
 
-  void SumMatrix(const S21Matrix& other);
-  bool EqMatrix(const S21Matrix& other) const noexcept;
-  void SubMatrix(const S21Matrix& other);
+  void SumMatrix(const S21BasicMatrix& other);
+  // tolerance s21::ScalarTraits<T>::kEpsilon
+  bool EqMatrix(const S21BasicMatrix& other) const noexcept;
+  void SubMatrix(const S21BasicMatrix& other);
   void MulNumber(const double num);
-  void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose() const;
-  S21Matrix CalcComplements() const;
-  S21Matrix InverseMatrix() const;
+  void MulMatrix(const S21BasicMatrix& other);
+  // MulMatrix by the Strassen-Winograd recursion, see
+  // s21_matrix_strassen.h: faster for large products, with a weaker
+  // (normwise) error bound. BFloat16 matrices use MulMatrix.
+  void MulMatrixStrassen(const S21BasicMatrix& other);
+  S21BasicMatrix Transpose() const;
+  // no allocation for square matrices, one bit per element otherwise
+  void TransposeInPlace();
+  S21BasicMatrix CalcComplements() const;
+  S21BasicMatrix InverseMatrix() const;
   double Determinant() const;
 
   // operators
 
-  S21Matrix operator+(const S21Matrix& other) const;
-  S21Matrix operator-(const S21Matrix& other) const;
-  S21Matrix operator*(const S21Matrix& other) const;
-  S21Matrix operator*(const double number) const;
-  bool operator==(const S21Matrix& other) const;
+  S21BasicMatrix operator+(const S21BasicMatrix& other) const;
+  S21BasicMatrix operator-(const S21BasicMatrix& other) const;
+  S21BasicMatrix operator*(const S21BasicMatrix& other) const;
+  S21BasicMatrix operator*(const double number) const;
+  bool operator==(const S21BasicMatrix& other) const;
+
+  S21BasicMatrix& operator+=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator-=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator*=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator*=(const double number);
+  S21BasicMatrix& operator=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(S21BasicMatrix&& other);
+  template <typename E>
+  S21BasicMatrix& operator=(const s21::MatrixExpr<E>& expr);
 
-  S21Matrix& operator+=(const S21Matrix& other);
-  S21Matrix& operator-=(const S21Matrix& other);
-  S21Matrix& operator*=(const S21Matrix& other);
-  S21Matrix& operator*=(const double number);
-  S21Matrix& operator=(const S21Matrix& other);
+  // throw std::out_of_range for indices outside the matrix
+  T& operator()(const int x, const int y);
+  const T& operator()(const int x, const int y) const;
+  T& At(const int x, const int y);
+  const T& At(const int x, const int y) const;
+  // no bounds check in release builds (NDEBUG), an assert otherwise; for
+  // inner loops that already know their bounds. The non-const one still
+  // detaches a shared copy-on-write buffer, like operator(); read-only
+  // loops through the const one vectorize without that branch.
+  T& UncheckedAt(const int x, const int y);
+  const T& UncheckedAt(const int x, const int y) const noexcept;
 
-  double& operator()(const int x, const int y);
-  friend S21Matrix operator*(const double number, const S21Matrix& other);
+  // Iterators
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+  s21::MatrixRows<T> Rows();
+  s21::MatrixRows<const T> Rows() const noexcept;
 
   // Accessors
 
   int GetRows() const noexcept;
   int GetCols() const noexcept;
 
+  // Raw row-major storage: element (i, j) lives at data()[i * stride() + j]
+
+  T* data();
+  const T* data() const noexcept;
+  int stride() const noexcept;
+  std::pmr::memory_resource* GetResource() const noexcept;
+  bool GetCopyOnWrite() const noexcept;
+
   // Mutators
 
   void SetRows(const int rows);
   void SetCols(const int cols);
+  // turning it off gives the matrix a buffer of its own; an empty matrix
+  // cannot be made copy-on-write
+  void SetCopyOnWrite(const bool on);
+
+  // Persistence: binary matrix files, see s21_matrix_io.h; elements are
+  // stored as double whatever T is
+
+  // replaces path atomically
+  void Save(const std::string& path) const;
+  // throws std::runtime_error on a malformed file or a checksum mismatch
+  static S21BasicMatrix Load(const std::string& path);
 
  private:
-  int rows_, cols_;
-  double** matrix_;
+  static constexpr std::size_t kAlignment = 64;
+
+  int rows_, cols_, stride_;
+  T* matrix_;
+  std::pmr::memory_resource* resource_;
+  // owners of matrix_, nullptr unless copy-on-write
+  std::atomic<int>* refs_;
 
   // help functions
 
+  T* Allocate(std::size_t count);
+  void Deallocate(T* buffer, std::size_t count) noexcept;
+  T* RowData(int i) noexcept;
+  const T* RowData(int i) const noexcept;
+  std::size_t Size() const noexcept;
   void Remove() noexcept;
+  // copy-on-write bookkeeping
+  std::atomic<int>* NewRefs();
+  void FreeRefs() noexcept;
+  bool Share(const S21BasicMatrix& other);
+  void Detach();
+  void DetachBuffer();
+  // the detaching path of operator() and UncheckedAt
+  __attribute__((noinline)) T& DetachAt(int x, int y);
   void MallocMatrix(int x, int y);
-  void SumStr(int row, int ro, double tmp) noexcept;
-  void Minor(int i, int j, S21Matrix& other) noexcept;
-  void CopyMatrix(const S21Matrix& other) noexcept;
+  void Minor(int i, int j, S21BasicMatrix& other) const noexcept;
+  void CopyMatrix(const S21BasicMatrix& other);
   void ZeroMatrix() noexcept;
-  int Sdvig(int i, int j) noexcept;
-  int Triangulate(S21Matrix& other) noexcept;
-  void CheckMistakes(const S21Matrix& other, const int number) const;
+  void Identity() noexcept;
+  template <typename F>
+  void ForRows(F&& body);
+  // LU of this in the compute type
+  int Triangulate(S21BasicMatrix<s21::ComputeType<T>>& lu, int* perm) const;
+  void CheckMistakes(const S21BasicMatrix& other, const int number) const;
   void CheckMistakes2(const int number) const;
+
+  template <typename U>
+  friend class S21BasicMatrix;
 };
 
-S21Matrix operator*(const double number, const S21Matrix& other);
+using S21Matrix = S21BasicMatrix<double>;
+using S21MatrixF = S21BasicMatrix<float>;
+using S21MatrixBF16 = S21BasicMatrix<s21::BFloat16>;
+
+// Element access, shape and iterators are inline (and ahead of the extern
+// template declarations, which would suppress that) so that loops over
+// them compile to plain pointer arithmetic
+
+template <typename T>
+inline int S21BasicMatrix<T>::GetRows() const noexcept {
+  return rows_;
+}
+
+template <typename T>
+inline int S21BasicMatrix<T>::GetCols() const noexcept {
+  return cols_;
+}
+
+template <typename T>
+inline void S21BasicMatrix<T>::Detach() {
+  if (refs_ != nullptr && refs_->load(std::memory_order_acquire) > 1) {
+    DetachBuffer();
+  }
+}
+
+template <typename T>
+inline T* S21BasicMatrix<T>::data() {
+  Detach();
+  return matrix_;
+}
+
+template <typename T>
+inline const T* S21BasicMatrix<T>::data() const noexcept {
+  return matrix_;
+}
+
+template <typename T>
+inline int S21BasicMatrix<T>::stride() const noexcept {
+  return stride_;
+}
+
+template <typename T>
+inline T& S21BasicMatrix<T>::UncheckedAt(const int x, const int y) {
+  assert(x >= 0 && x < rows_ && y >= 0 && y < cols_);
+  if (refs_ != nullptr && refs_->load(std::memory_order_acquire) > 1) {
+    return DetachAt(x, y);
+  }
+  return matrix_[static_cast<std::ptrdiff_t>(x) * stride_ + y];
+}
+
+template <typename T>
+inline const T& S21BasicMatrix<T>::UncheckedAt(const int x,
+                                               const int y) const noexcept {
+  assert(x >= 0 && x < rows_ && y >= 0 && y < cols_);
+  return matrix_[static_cast<std::ptrdiff_t>(x) * stride_ + y];
+}
+
+template <typename T>
+inline T& S21BasicMatrix<T>::At(const int x, const int y) {
+  return (*this)(x, y);
+}
+
+template <typename T>
+inline const T& S21BasicMatrix<T>::At(const int x, const int y) const {
+  return (*this)(x, y);
+}
+
+template <typename T>
+inline T* S21BasicMatrix<T>::begin() {
+  Detach();
+  return matrix_;
+}
+
+template <typename T>
+inline T* S21BasicMatrix<T>::end() {
+  Detach();
+  return matrix_ + static_cast<std::ptrdiff_t>(rows_) * stride_;
+}
+
+template <typename T>
+inline const T* S21BasicMatrix<T>::begin() const noexcept {
+  return matrix_;
+}
+
+template <typename T>
+inline const T* S21BasicMatrix<T>::end() const noexcept {
+  return matrix_ + static_cast<std::ptrdiff_t>(rows_) * stride_;
+}
+
+template <typename T>
+inline const T* S21BasicMatrix<T>::cbegin() const noexcept {
+  return begin();
+}
+
+template <typename T>
+inline const T* S21BasicMatrix<T>::cend() const noexcept {
+  return end();
+}
+
+template <typename T>
+inline s21::MatrixRows<T> S21BasicMatrix<T>::Rows() {
+  Detach();
+  return {matrix_, rows_, cols_, stride_};
+}
+
+template <typename T>
+inline s21::MatrixRows<const T> S21BasicMatrix<T>::Rows() const noexcept {
+  return {matrix_, rows_, cols_, stride_};
+}
+
+// defined in s21_matrix_oop.cc
+extern template class S21BasicMatrix<double>;
+extern template class S21BasicMatrix<float>;
+extern template class S21BasicMatrix<s21::BFloat16>;
+
+template <typename T>
+template <typename U>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix<U>& other)
+    : S21BasicMatrix() {
+  MallocMatrix(other.GetRows(), other.GetCols());
+  for (int i = 0; i < rows_; i++) {
+    const U* src = other.data() + static_cast<std::size_t>(i) * other.stride();
+    std::copy(src, src + cols_, RowData(i));
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(const double number,
+                            const S21BasicMatrix<T>& other) {
+  return other * number;
+}
+
+// Expiring operands lend their buffer to the result instead of copying
+
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T>&& left,
+                            const S21BasicMatrix<T>& right) {
+  left.SumMatrix(right);
+  return std::move(left);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator+(const S21BasicMatrix<T>& left,
+                            S21BasicMatrix<T>&& right) {
+  right.SumMatrix(left);
+  return std::move(right);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T>&& left,
+                            S21BasicMatrix<T>&& right) {
+  left.SumMatrix(right);
+  return std::move(left);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T>&& left,
+                            const S21BasicMatrix<T>& right) {
+  left.SubMatrix(right);
+  return std::move(left);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(S21BasicMatrix<T>&& left, const double number) {
+  left.MulNumber(number);
+  return std::move(left);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(const double number, S21BasicMatrix<T>&& other) {
+  other.MulNumber(number);
+  return std::move(other);
+}
 
 #endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_OOP_H_
\ No newline at end of file
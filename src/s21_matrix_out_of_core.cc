@@ -0,0 +1,220 @@
+// created by pizpotli
+#include "s21_matrix_out_of_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "s21_matrix_io.h"
+#include "s21_matrix_oop.h"
+#include "s21_matrix_view.h"
+
+namespace {
+
+// Elements that fit in budget when it is split into parts equal buffers.
+std::size_t BufferElements(std::size_t budget, std::size_t parts) {
+  return std::max<std::size_t>(budget / sizeof(double) / parts, 1);
+}
+
+int Clamp(std::size_t value, int limit) {
+  return static_cast<int>(
+      std::clamp<std::size_t>(value, 1, static_cast<std::size_t>(limit)));
+}
+
+int Blocks(int n, int block) { return (n + block - 1) / block; }
+
+// Calls load(step, slot) for every step on one prefetch thread while
+// compute(step, slot) of the previous step runs; the two slots name the
+// alternating buffers, so a load never touches the buffers being computed.
+// The loader runs at most one step ahead and sleeps until its slot is
+// free. An exception of either side is rethrown here.
+void Pipeline(int steps, const std::function<void(int, int)>& load,
+              const std::function<void(int, int)>& compute) {
+  std::mutex mutex;
+  std::condition_variable changed;
+  int loaded = 0, computed = 0;
+  bool stop = false;
+  std::exception_ptr error;
+  std::thread loader([&] {
+    for (int step = 0; step < steps; step++) {
+      {
+        // the slot of step was last used by step - 2
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return stop || computed >= step - 1; });
+        if (stop) return;
+      }
+      try {
+        load(step, step % 2);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = std::current_exception();
+        changed.notify_all();
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      loaded = step + 1;
+      changed.notify_all();
+    }
+  });
+  try {
+    for (int step = 0; step < steps; step++) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return loaded > step || error; });
+        if (loaded <= step) std::rethrow_exception(error);
+      }
+      compute(step, step % 2);
+      std::lock_guard<std::mutex> lock(mutex);
+      computed = step + 1;
+      changed.notify_all();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    changed.notify_all();
+    loader.join();
+    throw;
+  }
+  loader.join();
+}
+
+S21MatrixView Top(S21Matrix& buffer, int rows, int cols) {
+  return S21MatrixView(buffer).Block(0, 0, rows, cols);
+}
+
+}  // namespace
+
+namespace s21 {
+
+void OutOfCoreSumMatrix(const std::string& a, const std::string& b,
+                        const std::string& result,
+                        std::size_t memory_budget) {
+  const S21MatrixReader left(a), right(b);
+  const int rows = left.GetRows(), cols = left.GetCols();
+  if (right.GetRows() != rows || right.GetCols() != cols) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+  // two row blocks of each operand; the sum replaces the left one
+  const int chunk = Clamp(BufferElements(memory_budget, 4) / cols, rows);
+  S21Matrix left_chunks[2] = {{chunk, cols}, {chunk, cols}};
+  S21Matrix right_chunks[2] = {{chunk, cols}, {chunk, cols}};
+  S21MatrixWriter writer(result, rows, cols);
+  auto count = [&](int step) { return std::min(chunk, rows - step * chunk); };
+  Pipeline(
+      Blocks(rows, chunk),
+      [&](int step, int slot) {
+        left.ReadBlock(step * chunk, 0,
+                       Top(left_chunks[slot], count(step), cols));
+        right.ReadBlock(step * chunk, 0,
+                        Top(right_chunks[slot], count(step), cols));
+      },
+      [&](int step, int slot) {
+        const S21MatrixView sum = Top(left_chunks[slot], count(step), cols);
+        sum.SumMatrix(Top(right_chunks[slot], count(step), cols));
+        writer.WriteRows(sum);
+      });
+  writer.Close();
+}
+
+void OutOfCoreTranspose(const std::string& a, const std::string& result,
+                        std::size_t memory_budget) {
+  const S21MatrixReader source(a);
+  const int rows = source.GetRows(), cols = source.GetCols();
+  // two source tiles and one transposed tile; thin matrices get tiles of
+  // whole rows or columns
+  const std::size_t elements = BufferElements(memory_budget, 3);
+  const int tile_rows = Clamp(
+      static_cast<std::size_t>(std::sqrt(static_cast<double>(elements))),
+      rows);
+  const int tile_cols = Clamp(elements / tile_rows, cols);
+  S21Matrix tiles[2] = {{tile_rows, tile_cols}, {tile_rows, tile_cols}};
+  S21Matrix transposed(tile_cols, tile_rows);
+  S21MatrixWriter writer(result, cols, rows);
+  const int col_blocks = Blocks(cols, tile_cols);
+  auto extent = [&](int step, int* row, int* col, int* n, int* m) {
+    *row = step / col_blocks * tile_rows;
+    *col = step % col_blocks * tile_cols;
+    *n = std::min(tile_rows, rows - *row);
+    *m = std::min(tile_cols, cols - *col);
+  };
+  Pipeline(
+      Blocks(rows, tile_rows) * col_blocks,
+      [&](int step, int slot) {
+        int row, col, n, m;
+        extent(step, &row, &col, &n, &m);
+        source.ReadBlock(row, col, Top(tiles[slot], n, m));
+      },
+      [&](int step, int slot) {
+        int row, col, n, m;
+        extent(step, &row, &col, &n, &m);
+        const S21MatrixView out = Top(transposed, m, n);
+        out.Assign(Top(tiles[slot], n, m).TransposedView());
+        writer.WriteBlock(col, row, out);
+      });
+  writer.Close();
+}
+
+void OutOfCoreMulMatrix(const std::string& a, const std::string& b,
+                        const std::string& result,
+                        std::size_t memory_budget) {
+  const S21MatrixReader left(a), right(b);
+  const int m = left.GetRows(), k = left.GetCols(), n = right.GetCols();
+  if (right.GetRows() != k) {
+    throw std::out_of_range("ERROR: sides are not equal");
+  }
+  // two tiles of each operand and one result tile
+  const std::size_t side = static_cast<std::size_t>(
+      std::sqrt(static_cast<double>(BufferElements(memory_budget, 5))));
+  const int tm = Clamp(side, m), tk = Clamp(side, k), tn = Clamp(side, n);
+  S21Matrix left_tiles[2] = {{tm, tk}, {tm, tk}};
+  S21Matrix right_tiles[2] = {{tk, tn}, {tk, tn}};
+  S21Matrix product(tm, tn);
+  S21MatrixWriter writer(result, m, n);
+  const int k_blocks = Blocks(k, tk), n_blocks = Blocks(n, tn);
+  // step = (row block * n_blocks + column block) * k_blocks + inner block
+  struct Tile {
+    int row, col, inner, rows, cols, depth;
+  };
+  auto tile = [&](int step) {
+    Tile t;
+    t.row = step / k_blocks / n_blocks * tm;
+    t.col = step / k_blocks % n_blocks * tn;
+    t.inner = step % k_blocks * tk;
+    t.rows = std::min(tm, m - t.row);
+    t.cols = std::min(tn, n - t.col);
+    t.depth = std::min(tk, k - t.inner);
+    return t;
+  };
+  Pipeline(
+      Blocks(m, tm) * n_blocks * k_blocks,
+      [&](int step, int slot) {
+        const Tile t = tile(step);
+        left.ReadBlock(t.row, t.inner, Top(left_tiles[slot], t.rows, t.depth));
+        right.ReadBlock(t.inner, t.col,
+                        Top(right_tiles[slot], t.depth, t.cols));
+      },
+      [&](int step, int slot) {
+        const Tile t = tile(step);
+        const S21MatrixView out = Top(product, t.rows, t.cols);
+        if (t.inner == 0) {
+          for (int i = 0; i < t.rows; i++) {
+            std::fill_n(&out(i, 0), t.cols, 0.0);
+          }
+        }
+        out.MulAdd(Top(left_tiles[slot], t.rows, t.depth),
+                   Top(right_tiles[slot], t.depth, t.cols));
+        if (t.inner + t.depth == k) {
+          writer.WriteBlock(t.row, t.col, out);
+        }
+      });
+  writer.Close();
+}
+
+}  // namespace s21
@@ -0,0 +1,35 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_OUT_OF_CORE_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_OUT_OF_CORE_H_
+
+#include <cstddef>
+#include <string>
+
+// Operations on matrix files (see s21_matrix_io.h) that may be larger than
+// memory. Operands are processed in tiles sized to memory_budget bytes of
+// buffers, at least one row or one element per tile; while a tile is being
+// computed the next one is already read in the background. The result
+// file is replaced atomically when the operation succeeds.
+
+namespace s21 {
+
+constexpr std::size_t kOutOfCoreBudget = std::size_t{256} << 20;
+
+// result = a + b, streamed in row blocks
+void OutOfCoreSumMatrix(const std::string& a, const std::string& b,
+                        const std::string& result,
+                        std::size_t memory_budget = kOutOfCoreBudget);
+
+// result = a^T, tile by tile
+void OutOfCoreTranspose(const std::string& a, const std::string& result,
+                        std::size_t memory_budget = kOutOfCoreBudget);
+
+// result = a * b; every result tile stays in memory while the matching
+// tiles of a and b stream past it
+void OutOfCoreMulMatrix(const std::string& a, const std::string& b,
+                        const std::string& result,
+                        std::size_t memory_budget = kOutOfCoreBudget);
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_OUT_OF_CORE_H_
@@ -0,0 +1,78 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SCALAR_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SCALAR_H_
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Element types of S21BasicMatrix and what they compute in.
+
+namespace s21 {
+
+// 16-bit storage format: the upper half of an IEEE float (8 exponent bits,
+// 7 mantissa bits). Halves memory traffic against float at the same range;
+// arithmetic is done after widening to float.
+class BFloat16 {
+ public:
+  BFloat16() noexcept = default;
+  // rounds to nearest even; NaN stays NaN
+  BFloat16(float value) noexcept  // NOLINT: converts like a float
+      : bits_(Round(value)) {}
+
+  operator float() const noexcept {  // NOLINT
+    const std::uint32_t bits = static_cast<std::uint32_t>(bits_) << 16;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::uint16_t bits() const noexcept { return bits_; }
+
+ private:
+  std::uint16_t bits_;
+
+  static std::uint16_t Round(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+      return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+    }
+    bits += 0x7fffu + ((bits >> 16) & 1u);
+    return static_cast<std::uint16_t>(bits >> 16);
+  }
+};
+
+// Compute: type that elements are widened to for arithmetic and
+// accumulation. Epsilon: tolerance of EqMatrix.
+template <typename T>
+struct ScalarTraits;
+
+template <>
+struct ScalarTraits<double> {
+  using Compute = double;
+  static constexpr double kEpsilon = 1e-6;
+};
+
+template <>
+struct ScalarTraits<float> {
+  using Compute = float;
+  static constexpr double kEpsilon = 1e-4;
+};
+
+template <>
+struct ScalarTraits<BFloat16> {
+  using Compute = float;
+  static constexpr double kEpsilon = 1e-2;
+};
+
+template <typename T>
+using ComputeType = typename ScalarTraits<T>::Compute;
+
+// true if T is stored in a narrower type than it is computed in
+template <typename T>
+constexpr bool kWidened = !std::is_same<T, ComputeType<T>>::value;
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SCALAR_H_
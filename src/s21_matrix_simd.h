@@ -0,0 +1,52 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SIMD_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s21 {
+namespace simd {
+
+enum class Isa { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Element-wise kernels over n contiguous elements of type T (double or
+// float). Every instruction set provides the same table and gives
+// bit-identical results to the scalar reference (no FMA contraction), so
+// output does not depend on the host.
+template <typename T>
+struct BasicKernels {
+  Isa isa;
+  void (*add)(T* dst, const T* src, std::size_t n);
+  void (*sub)(T* dst, const T* src, std::size_t n);
+  void (*scale)(T* dst, T num, std::size_t n);
+  // dst += src * alpha
+  void (*axpy)(T* dst, const T* src, T alpha, std::size_t n);
+  // false if any |a[i] - b[i]| > eps
+  bool (*equal)(const T* a, const T* b, std::size_t n, T eps);
+  // dst[j * ldd + i] = src[i * lds + j] for a rows x cols block, done in
+  // register tiles (doubles: 2x2 SSE2, 4x4 AVX2 and AVX-512; floats: 4x4
+  // SSE2, 8x8 AVX2 and AVX-512)
+  void (*transpose)(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+                    std::size_t rows, std::size_t cols);
+};
+
+using Kernels = BasicKernels<double>;
+
+bool Supported(Isa isa) noexcept;
+template <typename T = double>
+const BasicKernels<T>& KernelsFor(Isa isa);
+
+// Best kernels for the running CPU, detected once via cpuid.
+template <typename T = double>
+const BasicKernels<T>& Active() noexcept;
+
+// Bit patterns of s21::BFloat16 to float and back, rounding like
+// s21::BFloat16; eight elements per instruction with AVX2.
+void WidenBf16(const std::uint16_t* src, float* dst, std::size_t n) noexcept;
+void NarrowBf16(const float* src, std::uint16_t* dst, std::size_t n) noexcept;
+
+}  // namespace simd
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SIMD_H_
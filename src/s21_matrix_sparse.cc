@@ -0,0 +1,418 @@
+// created by pizpotli
+#include "s21_matrix_sparse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Sparse x dense products go parallel above this many multiply-adds.
+constexpr long kParallelWork = 1 << 16;
+
+using Format = S21SparseMatrix::Format;
+
+Format Other(Format format) {
+  return format == Format::kCsr ? Format::kCsc : Format::kCsr;
+}
+
+}  // namespace
+
+// KONSTRUCTORS
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols, Format format)
+    : rows_(rows), cols_(cols), format_(format) {
+  if (rows < 1 || cols < 1) {
+    throw std::out_of_range("ERROR: incorrect matrix");
+  }
+  offsets_.assign(Lines() + 1, 0);
+}
+
+S21SparseMatrix::S21SparseMatrix(const S21Matrix& dense, Format format,
+                                 double threshold)
+    : S21SparseMatrix(dense.GetRows(), dense.GetCols(), format) {
+  const double* data = dense.data();
+  const std::ptrdiff_t major = format == Format::kCsr ? dense.stride() : 1;
+  const std::ptrdiff_t minor = format == Format::kCsr ? 1 : dense.stride();
+  for (int line = 0; line < Lines(); line++) {
+    for (int k = 0; k < LineLength(); k++) {
+      const double value = data[line * major + k * minor];
+      // NaN is kept
+      if (!(std::fabs(value) <= threshold)) {
+        indices_.push_back(k);
+        values_.push_back(value);
+      }
+    }
+    offsets_[line + 1] = static_cast<int>(indices_.size());
+  }
+}
+
+S21SparseMatrix S21SparseMatrix::FromTriplets(
+    int rows, int cols, const std::vector<Triplet>& triplets, Format format) {
+  S21SparseMatrix result(rows, cols, format);
+  const bool csr = format == Format::kCsr;
+  for (const Triplet& t : triplets) {
+    if (t.row < 0 || t.row >= rows || t.col < 0 || t.col >= cols) {
+      throw std::out_of_range("ERROR: index outside matrix");
+    }
+    result.offsets_[(csr ? t.row : t.col) + 1]++;
+  }
+  std::partial_sum(result.offsets_.begin(), result.offsets_.end(),
+                   result.offsets_.begin());
+  // bucket by line, then sort every line and merge duplicates
+  std::vector<int> next(result.offsets_.begin(), result.offsets_.end() - 1);
+  std::vector<std::pair<int, double>> entries(triplets.size());
+  for (const Triplet& t : triplets) {
+    entries[next[csr ? t.row : t.col]++] = {csr ? t.col : t.row, t.value};
+  }
+  int stored = 0;
+  for (int line = 0; line < result.Lines(); line++) {
+    const auto first = entries.begin() + result.offsets_[line];
+    const auto last = entries.begin() + result.offsets_[line + 1];
+    std::stable_sort(first, last, [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+    result.offsets_[line] = stored;
+    for (auto it = first; it != last; ++it) {
+      if (stored > result.offsets_[line] &&
+          result.indices_.back() == it->first) {
+        result.values_.back() += it->second;
+      } else {
+        result.indices_.push_back(it->first);
+        result.values_.push_back(it->second);
+        stored++;
+      }
+    }
+  }
+  result.offsets_.back() = stored;
+  return result;
+}
+
+// CONVERSIONS
+
+S21Matrix S21SparseMatrix::ToDense() const {
+  S21Matrix dense(rows_, cols_);
+  const std::ptrdiff_t major = format_ == Format::kCsr ? dense.stride() : 1;
+  const std::ptrdiff_t minor = format_ == Format::kCsr ? 1 : dense.stride();
+  for (int line = 0; line < Lines(); line++) {
+    for (int k = offsets_[line]; k < offsets_[line + 1]; k++) {
+      dense.data()[line * major + indices_[k] * minor] = values_[k];
+    }
+  }
+  return dense;
+}
+
+S21SparseMatrix S21SparseMatrix::ToFormat(Format format) const {
+  if (format == format_) {
+    return *this;
+  }
+  // counting sort by minor index; visiting the lines in order leaves every
+  // new line sorted
+  S21SparseMatrix result(rows_, cols_, format);
+  for (int index : indices_) {
+    result.offsets_[index + 1]++;
+  }
+  std::partial_sum(result.offsets_.begin(), result.offsets_.end(),
+                   result.offsets_.begin());
+  std::vector<int> next(result.offsets_.begin(), result.offsets_.end() - 1);
+  result.indices_.resize(indices_.size());
+  result.values_.resize(values_.size());
+  for (int line = 0; line < Lines(); line++) {
+    for (int k = offsets_[line]; k < offsets_[line + 1]; k++) {
+      const int to = next[indices_[k]]++;
+      result.indices_[to] = line;
+      result.values_[to] = values_[k];
+    }
+  }
+  return result;
+}
+
+// ARITHMETICS
+
+void S21SparseMatrix::SumMatrix(const S21SparseMatrix& other) {
+  Combine(other, 1.0);
+}
+
+void S21SparseMatrix::SubMatrix(const S21SparseMatrix& other) {
+  Combine(other, -1.0);
+}
+
+void S21SparseMatrix::MulNumber(const double num) {
+  s21::simd::Active().scale(values_.data(), num, values_.size());
+}
+
+S21SparseMatrix S21SparseMatrix::MulMatrix(
+    const S21SparseMatrix& other) const {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range("ERROR: sides are not equal");
+  }
+  if (other.format_ != format_) {
+    return MulMatrix(other.ToFormat(format_));
+  }
+  S21SparseMatrix result(rows_, other.cols_, format_);
+  if (format_ == Format::kCsr) {
+    MulLines(*this, other, result);
+  } else {
+    // a column of the product combines columns of this
+    MulLines(other, *this, result);
+  }
+  return result;
+}
+
+S21Matrix S21SparseMatrix::MulMatrix(const S21Matrix& other) const {
+  if (cols_ != other.GetRows()) {
+    throw std::out_of_range("ERROR: sides are not equal");
+  }
+  const int n = other.GetCols();
+  S21Matrix result(rows_, n);
+  const s21::simd::Kernels& kernels = s21::simd::Active();
+  const double* b = other.data();
+  double* c = result.data();
+  const std::ptrdiff_t ldb = other.stride(), ldc = result.stride();
+  if (format_ == Format::kCsc) {
+    // column j of this scatters row j of other into the result rows
+    for (int j = 0; j < cols_; j++) {
+      for (int k = offsets_[j]; k < offsets_[j + 1]; k++) {
+        kernels.axpy(c + indices_[k] * ldc, b + j * ldb, values_[k], n);
+      }
+    }
+    return result;
+  }
+  auto body = [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      for (int k = offsets_[i]; k < offsets_[i + 1]; k++) {
+        kernels.axpy(c + i * ldc, b + indices_[k] * ldb, values_[k], n);
+      }
+    }
+  };
+  if (static_cast<long>(values_.size()) * n < kParallelWork) {
+    body(0, rows_);
+  } else {
+    S21ThreadPool::Global().ParallelFor(rows_, 1, body);
+  }
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::Transpose() const {
+  S21SparseMatrix result(*this);
+  std::swap(result.rows_, result.cols_);
+  result.format_ = Other(format_);
+  return result;
+}
+
+bool S21SparseMatrix::EqMatrix(const S21SparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    return false;
+  }
+  if (other.format_ != format_) {
+    return EqMatrix(other.ToFormat(format_));
+  }
+  // a stored element may match one that is not stored in the other
+  for (int line = 0; line < Lines(); line++) {
+    int a = offsets_[line], b = other.offsets_[line];
+    const int a_end = offsets_[line + 1], b_end = other.offsets_[line + 1];
+    while (a < a_end || b < b_end) {
+      double diff;
+      if (b == b_end || (a < a_end && indices_[a] < other.indices_[b])) {
+        diff = values_[a++];
+      } else if (a == a_end || other.indices_[b] < indices_[a]) {
+        diff = other.values_[b++];
+      } else {
+        diff = values_[a++] - other.values_[b++];
+      }
+      if (!(std::fabs(diff) <= 1e-6)) return false;
+    }
+  }
+  return true;
+}
+
+// OPERATORS
+
+S21SparseMatrix S21SparseMatrix::operator+(
+    const S21SparseMatrix& other) const {
+  S21SparseMatrix result(*this);
+  result.SumMatrix(other);
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::operator-(
+    const S21SparseMatrix& other) const {
+  S21SparseMatrix result(*this);
+  result.SubMatrix(other);
+  return result;
+}
+
+S21SparseMatrix S21SparseMatrix::operator*(
+    const S21SparseMatrix& other) const {
+  return MulMatrix(other);
+}
+
+S21Matrix S21SparseMatrix::operator*(const S21Matrix& other) const {
+  return MulMatrix(other);
+}
+
+S21SparseMatrix S21SparseMatrix::operator*(const double number) const {
+  S21SparseMatrix result(*this);
+  result.MulNumber(number);
+  return result;
+}
+
+S21SparseMatrix operator*(const double number, const S21SparseMatrix& other) {
+  return other * number;
+}
+
+bool S21SparseMatrix::operator==(const S21SparseMatrix& other) const {
+  return EqMatrix(other);
+}
+
+S21SparseMatrix& S21SparseMatrix::operator+=(const S21SparseMatrix& other) {
+  SumMatrix(other);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator-=(const S21SparseMatrix& other) {
+  SubMatrix(other);
+  return *this;
+}
+
+S21SparseMatrix& S21SparseMatrix::operator*=(const double number) {
+  MulNumber(number);
+  return *this;
+}
+
+double S21SparseMatrix::operator()(const int x, const int y) const {
+  if (x >= rows_ || y >= cols_ || x < 0 || y < 0) {
+    throw std::out_of_range("ERROR: index outside matrix");
+  }
+  const int line = format_ == Format::kCsr ? x : y;
+  const int index = format_ == Format::kCsr ? y : x;
+  const auto first = indices_.begin() + offsets_[line];
+  const auto last = indices_.begin() + offsets_[line + 1];
+  const auto it = std::lower_bound(first, last, index);
+  return it != last && *it == index ? values_[it - indices_.begin()] : 0.0;
+}
+
+// ACCESSORS
+
+int S21SparseMatrix::GetRows() const noexcept { return rows_; }
+
+int S21SparseMatrix::GetCols() const noexcept { return cols_; }
+
+S21SparseMatrix::Format S21SparseMatrix::GetFormat() const noexcept {
+  return format_;
+}
+
+std::size_t S21SparseMatrix::GetNonZeros() const noexcept {
+  return values_.size();
+}
+
+std::size_t S21SparseMatrix::GetMemoryUsage() const noexcept {
+  return sizeof(int) * (offsets_.size() + indices_.size()) +
+         sizeof(double) * values_.size();
+}
+
+const std::vector<int>& S21SparseMatrix::offsets() const noexcept {
+  return offsets_;
+}
+
+const std::vector<int>& S21SparseMatrix::indices() const noexcept {
+  return indices_;
+}
+
+const std::vector<double>& S21SparseMatrix::values() const noexcept {
+  return values_;
+}
+
+// HELP FUNCTIONS
+
+int S21SparseMatrix::Lines() const noexcept {
+  return format_ == Format::kCsr ? rows_ : cols_;
+}
+
+int S21SparseMatrix::LineLength() const noexcept {
+  return format_ == Format::kCsr ? cols_ : rows_;
+}
+
+void S21SparseMatrix::Combine(const S21SparseMatrix& other, double sign) {
+  CheckSize(other);
+  if (other.format_ != format_) {
+    Combine(other.ToFormat(format_), sign);
+    return;
+  }
+  // merge the sorted lines; exact cancellations are not stored
+  std::vector<int> offsets(offsets_.size(), 0), indices;
+  std::vector<double> values;
+  indices.reserve(indices_.size() + other.indices_.size());
+  values.reserve(indices.capacity());
+  for (int line = 0; line < Lines(); line++) {
+    int a = offsets_[line], b = other.offsets_[line];
+    const int a_end = offsets_[line + 1], b_end = other.offsets_[line + 1];
+    while (a < a_end || b < b_end) {
+      int index;
+      double value;
+      if (b == b_end || (a < a_end && indices_[a] < other.indices_[b])) {
+        index = indices_[a];
+        value = values_[a++];
+      } else if (a == a_end || other.indices_[b] < indices_[a]) {
+        index = other.indices_[b];
+        value = sign * other.values_[b++];
+      } else {
+        index = indices_[a];
+        value = values_[a++] + sign * other.values_[b++];
+      }
+      if (value != 0.0) {
+        indices.push_back(index);
+        values.push_back(value);
+      }
+    }
+    offsets[line + 1] = static_cast<int>(indices.size());
+  }
+  offsets_.swap(offsets);
+  indices_.swap(indices);
+  values_.swap(values);
+}
+
+void S21SparseMatrix::CheckSize(const S21SparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::out_of_range("ERROR: different dimensions of matrices");
+  }
+}
+
+void S21SparseMatrix::MulLines(const S21SparseMatrix& left,
+                               const S21SparseMatrix& right,
+                               S21SparseMatrix& result) {
+  // Gustavson: a dense accumulator for the current line plus the list of
+  // positions touched in it
+  const int width = right.LineLength();
+  std::vector<double> accumulator(width, 0.0);
+  std::vector<int> touched_by(width, -1), touched;
+  for (int line = 0; line < left.Lines(); line++) {
+    touched.clear();
+    for (int a = left.offsets_[line]; a < left.offsets_[line + 1]; a++) {
+      const int k = left.indices_[a];
+      const double scale = left.values_[a];
+      for (int b = right.offsets_[k]; b < right.offsets_[k + 1]; b++) {
+        const int index = right.indices_[b];
+        if (touched_by[index] != line) {
+          touched_by[index] = line;
+          touched.push_back(index);
+          accumulator[index] = 0.0;
+        }
+        accumulator[index] += scale * right.values_[b];
+      }
+    }
+    std::sort(touched.begin(), touched.end());
+    for (int index : touched) {
+      if (accumulator[index] != 0.0) {
+        result.indices_.push_back(index);
+        result.values_.push_back(accumulator[index]);
+      }
+    }
+    result.offsets_[line + 1] = static_cast<int>(result.indices_.size());
+  }
+}
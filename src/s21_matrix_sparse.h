@@ -0,0 +1,104 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SPARSE_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SPARSE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Compressed sparse matrix in row (CSR) or column (CSC) layout. Only the
+// non-zero elements are stored: for every row (column) of a CSR (CSC)
+// matrix, offsets() tells where its run of indices() and values() starts;
+// within a run the indices are strictly increasing. Memory and work grow
+// with the number of non-zeros instead of rows * cols.
+class S21SparseMatrix {
+ public:
+  enum class Format { kCsr, kCsc };
+
+  struct Triplet {
+    int row, col;
+    double value;
+  };
+
+  // Konstructors
+
+  // rows x cols of zeros
+  S21SparseMatrix(int rows, int cols, Format format = Format::kCsr);
+  // the elements of dense with |value| > threshold
+  explicit S21SparseMatrix(const S21Matrix& dense,
+                           Format format = Format::kCsr,
+                           double threshold = 0.0);
+  // values at repeated positions are summed
+  static S21SparseMatrix FromTriplets(int rows, int cols,
+                                      const std::vector<Triplet>& triplets,
+                                      Format format = Format::kCsr);
+
+  // Conversions
+
+  S21Matrix ToDense() const;
+  // same matrix in the other layout; a copy if it already is in format
+  S21SparseMatrix ToFormat(Format format) const;
+
+  // Arithmetics
+
+  void SumMatrix(const S21SparseMatrix& other);
+  void SubMatrix(const S21SparseMatrix& other);
+  void MulNumber(const double num);
+  // sparse result, keeps the layout of this
+  S21SparseMatrix MulMatrix(const S21SparseMatrix& other) const;
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  // O(nnz) copy: the transpose of a CSR matrix is the same arrays read as
+  // CSC
+  S21SparseMatrix Transpose() const;
+  bool EqMatrix(const S21SparseMatrix& other) const;
+
+  // operators
+
+  S21SparseMatrix operator+(const S21SparseMatrix& other) const;
+  S21SparseMatrix operator-(const S21SparseMatrix& other) const;
+  S21SparseMatrix operator*(const S21SparseMatrix& other) const;
+  S21Matrix operator*(const S21Matrix& other) const;
+  S21SparseMatrix operator*(const double number) const;
+  bool operator==(const S21SparseMatrix& other) const;
+  S21SparseMatrix& operator+=(const S21SparseMatrix& other);
+  S21SparseMatrix& operator-=(const S21SparseMatrix& other);
+  S21SparseMatrix& operator*=(const double number);
+
+  // element (x, y), zero if it is not stored; O(log nnz of the line)
+  double operator()(const int x, const int y) const;
+
+  // Accessors
+
+  int GetRows() const noexcept;
+  int GetCols() const noexcept;
+  Format GetFormat() const noexcept;
+  std::size_t GetNonZeros() const noexcept;
+  // bytes held by the three arrays
+  std::size_t GetMemoryUsage() const noexcept;
+  const std::vector<int>& offsets() const noexcept;
+  const std::vector<int>& indices() const noexcept;
+  const std::vector<double>& values() const noexcept;
+
+ private:
+  int rows_, cols_;
+  Format format_;
+  std::vector<int> offsets_;
+  std::vector<int> indices_;
+  std::vector<double> values_;
+
+  // help functions
+
+  int Lines() const noexcept;
+  int LineLength() const noexcept;
+  void Combine(const S21SparseMatrix& other, double sign);
+  void CheckSize(const S21SparseMatrix& other) const;
+  // result line i = sum over k in line i of left of left(i, k) * line k
+  // of right; result must be sized and empty
+  static void MulLines(const S21SparseMatrix& left,
+                       const S21SparseMatrix& right, S21SparseMatrix& result);
+};
+
+S21SparseMatrix operator*(const double number, const S21SparseMatrix& other);
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_SPARSE_H_
@@ -0,0 +1,258 @@
+// created by pizpotli
+#include "s21_matrix_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+enum Field { kCalls, kFlops, kAllocated, kCopied, kNanoseconds, kFields };
+
+// Operations open on one thread that bytes are credited to; deeper
+// nesting than this is counted but not credited.
+constexpr int kMaxDepth = 16;
+
+constexpr const char* kOpNames[kMatrixOps] = {
+    "Construct",
+    "CopyConstruct",
+    "MoveConstruct",
+    "CopyAssign",
+    "MoveAssign",
+    "SumMatrix",
+    "SubMatrix",
+    "MulNumber",
+    "MulMatrix",
+    "MulMatrixStrassen",
+    "EqMatrix",
+    "Transpose",
+    "TransposeInPlace",
+    "CalcComplements",
+    "InverseMatrix",
+    "Determinant",
+    "SetRows",
+    "SetCols",
+    "MallocMatrix",
+    "CopyMatrix",
+    "Minor",
+    "Triangulate",
+    "Detach"};
+
+using Totals = std::array<std::array<std::uint64_t, kFields>, kMatrixOps>;
+
+struct ThreadSlots;
+
+// never destroyed: threads exiting after main still fold their counts in
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadSlots*> threads;
+  Totals retired{};
+  Totals baseline{};
+
+  static Registry& Get() {
+    static Registry* registry = new Registry;
+    return *registry;
+  }
+};
+
+// Written by the owning thread only, read by snapshots of any thread; a
+// relaxed load and store instead of fetch_add keeps the hot path free of
+// locked instructions.
+struct ThreadSlots {
+  std::array<std::array<std::atomic<std::uint64_t>, kFields>, kMatrixOps>
+      values;
+  MatrixOp open[kMaxDepth];
+  int depth = 0;
+
+  ThreadSlots() {
+    for (auto& op : values) {
+      for (auto& value : op) value.store(0, std::memory_order_relaxed);
+    }
+    Registry& registry = Registry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(this);
+  }
+
+  ~ThreadSlots() {
+    Registry& registry = Registry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    AddTo(registry.retired);
+    auto& threads = registry.threads;
+    threads.erase(std::find(threads.begin(), threads.end(), this));
+  }
+
+  static ThreadSlots& Get() {
+    thread_local ThreadSlots slots;
+    return slots;
+  }
+
+  void Add(MatrixOp op, Field field, std::uint64_t value) noexcept {
+    std::atomic<std::uint64_t>& slot = values[static_cast<int>(op)][field];
+    slot.store(slot.load(std::memory_order_relaxed) + value,
+               std::memory_order_relaxed);
+  }
+
+  void AddOpen(Field field, std::uint64_t value) noexcept {
+    for (int i = 0; i < depth; i++) Add(open[i], field, value);
+  }
+
+  bool IsOpen(MatrixOp op) const noexcept {
+    return std::find(open, open + depth, op) != open + depth;
+  }
+
+  void AddTo(Totals& totals) const noexcept {
+    for (int op = 0; op < kMatrixOps; op++) {
+      for (int field = 0; field < kFields; field++) {
+        totals[op][field] += values[op][field].load(std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+// retired plus live counts; the caller holds the registry mutex
+Totals Sum(const Registry& registry) {
+  Totals totals = registry.retired;
+  for (const ThreadSlots* slots : registry.threads) slots->AddTo(totals);
+  return totals;
+}
+
+std::int64_t Now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void WriteMetric(std::ostringstream& out, const MatrixStats& stats,
+                 const char* name, const char* help,
+                 std::uint64_t OpCounters::*field, double scale = 1) {
+  out << "# HELP " << name << ' ' << help << '\n';
+  out << "# TYPE " << name << " counter\n";
+  for (int op = 0; op < kMatrixOps; op++) {
+    const std::uint64_t value = stats.ops[op].*field;
+    out << name << "{op=\"" << kOpNames[op] << "\"} ";
+    if (scale == 1) {
+      out << value << '\n';
+    } else {
+      out << static_cast<double>(value) * scale << '\n';
+    }
+  }
+}
+
+}  // namespace
+
+// ACCESSORS
+
+bool StatsEnabled() noexcept {
+#ifdef S21_MATRIX_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+const char* OpName(MatrixOp op) noexcept {
+  return kOpNames[static_cast<int>(op)];
+}
+
+MatrixStats StatsSnapshot() {
+  Registry& registry = Registry::Get();
+  Totals totals;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    totals = Sum(registry);
+    for (int op = 0; op < kMatrixOps; op++) {
+      for (int field = 0; field < kFields; field++) {
+        totals[op][field] -= registry.baseline[op][field];
+      }
+    }
+  }
+  MatrixStats stats;
+  for (int op = 0; op < kMatrixOps; op++) {
+    stats.ops[op] = {totals[op][kCalls], totals[op][kFlops],
+                     totals[op][kAllocated], totals[op][kCopied],
+                     totals[op][kNanoseconds]};
+  }
+  return stats;
+}
+
+std::string StatsToJson(const MatrixStats& stats) {
+  std::ostringstream out;
+  out << '{';
+  for (int op = 0; op < kMatrixOps; op++) {
+    const OpCounters& counters = stats.ops[op];
+    out << (op ? ", " : "") << '"' << kOpNames[op] << "\": {"
+        << "\"calls\": " << counters.calls
+        << ", \"flops\": " << counters.flops
+        << ", \"bytes_allocated\": " << counters.bytes_allocated
+        << ", \"bytes_copied\": " << counters.bytes_copied
+        << ", \"nanoseconds\": " << counters.nanoseconds << '}';
+  }
+  out << '}';
+  return out.str();
+}
+
+std::string StatsToPrometheus(const MatrixStats& stats) {
+  std::ostringstream out;
+  out.precision(9);
+  WriteMetric(out, stats, "s21_matrix_calls_total",
+              "Calls of an S21Matrix operation.", &OpCounters::calls);
+  WriteMetric(out, stats, "s21_matrix_flops_total",
+              "Floating-point operations of an S21Matrix operation.",
+              &OpCounters::flops);
+  WriteMetric(out, stats, "s21_matrix_allocated_bytes_total",
+              "Bytes of matrix buffers allocated by an S21Matrix operation.",
+              &OpCounters::bytes_allocated);
+  WriteMetric(out, stats, "s21_matrix_copied_bytes_total",
+              "Bytes deep-copied by an S21Matrix operation.",
+              &OpCounters::bytes_copied);
+  WriteMetric(out, stats, "s21_matrix_seconds_total",
+              "Wall time spent in an S21Matrix operation.",
+              &OpCounters::nanoseconds, 1e-9);
+  return out.str();
+}
+
+// MUTATORS
+
+void ResetStats() {
+  Registry& registry = Registry::Get();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.baseline = Sum(registry);
+}
+
+// RECORDING
+
+StatsScope::StatsScope(MatrixOp op, std::uint64_t flops) noexcept
+    : op_(op), outermost_(false), start_(0) {
+  ThreadSlots& slots = ThreadSlots::Get();
+  slots.Add(op, kCalls, 1);
+  slots.Add(op, kFlops, flops);
+  // a nested call of an open operation is already timed by the outer one
+  if (slots.depth < kMaxDepth && !slots.IsOpen(op)) {
+    slots.open[slots.depth++] = op;
+    outermost_ = true;
+    start_ = Now();
+  }
+}
+
+StatsScope::~StatsScope() noexcept {
+  if (outermost_) {
+    ThreadSlots& slots = ThreadSlots::Get();
+    slots.Add(op_, kNanoseconds, static_cast<std::uint64_t>(Now() - start_));
+    slots.depth--;
+  }
+}
+
+void StatsAllocated(std::uint64_t bytes) noexcept {
+  ThreadSlots::Get().AddOpen(kAllocated, bytes);
+}
+
+void StatsCopied(std::uint64_t bytes) noexcept {
+  ThreadSlots::Get().AddOpen(kCopied, bytes);
+}
+
+}  // namespace s21
@@ -0,0 +1,115 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_STATS_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_STATS_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Per-operation counters of S21Matrix: calls, FLOPs, bytes allocated,
+// bytes deep-copied and wall time. They are recorded only by a library
+// built with S21_MATRIX_STATS defined (make STATS=1, cmake -DS21_STATS=ON);
+// otherwise the recording compiles to nothing and snapshots are all zero.
+// Each thread counts into slots of its own, so recording takes no lock.
+// Figures are inclusive: bytes and time of an operation include those of
+// the helpers it calls, which are also counted under their own names. FLOPs
+// are those of the textbook algorithm, also for MulMatrixStrassen.
+
+namespace s21 {
+
+enum class MatrixOp {
+  kConstruct,
+  kCopyConstruct,
+  kMoveConstruct,
+  kCopyAssign,
+  kMoveAssign,
+  kSumMatrix,
+  kSubMatrix,
+  kMulNumber,
+  kMulMatrix,
+  kMulMatrixStrassen,
+  kEqMatrix,
+  kTranspose,
+  kTransposeInPlace,
+  kCalcComplements,
+  kInverseMatrix,
+  kDeterminant,
+  kSetRows,
+  kSetCols,
+  kMallocMatrix,
+  kCopyMatrix,
+  kMinor,
+  kTriangulate,
+  kDetach,
+  kCount
+};
+
+constexpr int kMatrixOps = static_cast<int>(MatrixOp::kCount);
+
+struct OpCounters {
+  std::uint64_t calls = 0;
+  std::uint64_t flops = 0;
+  std::uint64_t bytes_allocated = 0;
+  std::uint64_t bytes_copied = 0;
+  std::uint64_t nanoseconds = 0;
+};
+
+struct MatrixStats {
+  std::array<OpCounters, kMatrixOps> ops;
+
+  const OpCounters& operator[](MatrixOp op) const noexcept {
+    return ops[static_cast<int>(op)];
+  }
+};
+
+// Whether the library was built to record.
+bool StatsEnabled() noexcept;
+// "SumMatrix" for MatrixOp::kSumMatrix and so on.
+const char* OpName(MatrixOp op) noexcept;
+
+// Counts of every thread, exited ones included, since the last
+// ResetStats(). Both may be called from any thread at any time.
+MatrixStats StatsSnapshot();
+void ResetStats();
+
+// {"SumMatrix": {"calls": 1, ...}, ...} with an entry for every operation.
+std::string StatsToJson(const MatrixStats& stats);
+// Prometheus text exposition: counters s21_matrix_calls_total,
+// s21_matrix_flops_total, s21_matrix_allocated_bytes_total,
+// s21_matrix_copied_bytes_total and s21_matrix_seconds_total, labelled by
+// op.
+std::string StatsToPrometheus(const MatrixStats& stats);
+
+// Recording, for the library itself through the S21_STATS_ macros below.
+// A scope counts a call and its time; bytes go to every operation open on
+// the calling thread.
+class StatsScope {
+ public:
+  explicit StatsScope(MatrixOp op, std::uint64_t flops = 0) noexcept;
+  StatsScope(const StatsScope&) = delete;
+  StatsScope& operator=(const StatsScope&) = delete;
+  ~StatsScope() noexcept;
+
+ private:
+  MatrixOp op_;
+  bool outermost_;
+  std::int64_t start_;
+};
+
+void StatsAllocated(std::uint64_t bytes) noexcept;
+void StatsCopied(std::uint64_t bytes) noexcept;
+
+}  // namespace s21
+
+#ifdef S21_MATRIX_STATS
+#define S21_STATS_SCOPE(op, flops) \
+  s21::StatsScope s21_stats_scope(s21::MatrixOp::op, flops)
+#define S21_STATS_ALLOCATED(bytes) s21::StatsAllocated(bytes)
+#define S21_STATS_COPIED(bytes) s21::StatsCopied(bytes)
+#else
+#define S21_STATS_SCOPE(op, flops) static_cast<void>(0)
+#define S21_STATS_ALLOCATED(bytes) static_cast<void>(0)
+#define S21_STATS_COPIED(bytes) static_cast<void>(0)
+#endif
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_STATS_H_
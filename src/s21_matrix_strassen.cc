@@ -0,0 +1,154 @@
+// created by pizpotli
+#include "s21_matrix_strassen.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "s21_matrix_gemm.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Additions of blocks with fewer elements stay on the calling thread.
+constexpr int kParallelElements = 1 << 16;
+
+// dst = x + sign * y for rows x cols blocks; dst may alias x or y.
+template <typename T>
+void Combine(int rows, int cols, const T* x, int ldx, const T* y, int ldy,
+             T sign, T* dst, int ldd) {
+  auto body = [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const T* xi = x + static_cast<std::ptrdiff_t>(i) * ldx;
+      const T* yi = y + static_cast<std::ptrdiff_t>(i) * ldy;
+      T* di = dst + static_cast<std::ptrdiff_t>(i) * ldd;
+      for (int j = 0; j < cols; j++) {
+        di[j] = xi[j] + sign * yi[j];
+      }
+    }
+  };
+  if (static_cast<long>(rows) * cols < kParallelElements) {
+    body(0, rows);
+  } else {
+    S21ThreadPool::Global().ParallelFor(rows, 1, body);
+  }
+}
+
+template <typename T>
+void Add(int rows, int cols, const T* x, int ldx, const T* y, int ldy,
+         T* dst, int ldd) {
+  Combine(rows, cols, x, ldx, y, ldy, T{1}, dst, ldd);
+}
+
+template <typename T>
+void Sub(int rows, int cols, const T* x, int ldx, const T* y, int ldy,
+         T* dst, int ldd) {
+  Combine(rows, cols, x, ldx, y, ldy, T{-1}, dst, ldd);
+}
+
+// c = a * b through the blocked kernel, which accumulates into c
+template <typename T>
+void ClassicGemm(int m, int n, int k, const T* a, int lda, const T* b,
+                 int ldb, T* c, int ldc) {
+  for (int i = 0; i < m; i++) {
+    std::fill_n(c + static_cast<std::ptrdiff_t>(i) * ldc, n, T{0});
+  }
+  Gemm(m, n, k, 1.0, a, lda, 1, b, ldb, 1, c, ldc);
+}
+
+bool IsLeaf(int m, int n, int k, int cutoff) {
+  return std::min({m, n, k}) <= std::max(cutoff, 1);
+}
+
+// One level on the even part of the operands, in the schedule of Boyer,
+// Dumas, Pernet and Zhou (2009): two temporaries X and Y, the quadrants
+// of C holding the other intermediate results.
+template <typename T>
+void Winograd(int m, int n, int k, const T* a, int lda, const T* b, int ldb,
+              T* c, int ldc, T* work, int cutoff) {
+  const int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  const std::ptrdiff_t rows_a = static_cast<std::ptrdiff_t>(m2) * lda;
+  const std::ptrdiff_t rows_b = static_cast<std::ptrdiff_t>(k2) * ldb;
+  const std::ptrdiff_t rows_c = static_cast<std::ptrdiff_t>(m2) * ldc;
+  const T *a11 = a, *a12 = a + k2, *a21 = a + rows_a, *a22 = a21 + k2;
+  const T *b11 = b, *b12 = b + n2, *b21 = b + rows_b, *b22 = b21 + n2;
+  T *c11 = c, *c12 = c + n2, *c21 = c + rows_c, *c22 = c21 + n2;
+  T* x = work;
+  T* y = x + static_cast<std::size_t>(m2) * std::max(k2, n2);
+  T* rest = y + static_cast<std::size_t>(k2) * n2;
+  auto mul = [&](const T* p, int ldp, const T* q, int ldq, T* r, int ldr) {
+    StrassenGemm(m2, n2, k2, p, ldp, q, ldq, r, ldr, rest, cutoff);
+  };
+
+  Sub(m2, k2, a11, lda, a21, lda, x, k2);  // S3
+  Sub(k2, n2, b22, ldb, b12, ldb, y, n2);  // T3
+  mul(x, k2, y, n2, c21, ldc);             // P7
+  Add(m2, k2, a21, lda, a22, lda, x, k2);  // S1
+  Sub(k2, n2, b12, ldb, b11, ldb, y, n2);  // T1
+  mul(x, k2, y, n2, c22, ldc);             // P5
+  Sub(m2, k2, x, k2, a11, lda, x, k2);     // S2
+  Sub(k2, n2, b22, ldb, y, n2, y, n2);     // T2
+  mul(x, k2, y, n2, c12, ldc);             // P6
+  Sub(m2, k2, a12, lda, x, k2, x, k2);     // S4
+  mul(x, k2, b22, ldb, c11, ldc);          // P3
+  mul(a11, lda, b11, ldb, x, n2);          // P1
+  Add(m2, n2, x, n2, c12, ldc, c12, ldc);  // U2 = P1 + P6
+  Add(m2, n2, c12, ldc, c21, ldc, c21, ldc);  // U3 = U2 + P7
+  Add(m2, n2, c12, ldc, c22, ldc, c12, ldc);  // U4 = U2 + P5
+  Add(m2, n2, c21, ldc, c22, ldc, c22, ldc);  // U7 = U3 + P5
+  Add(m2, n2, c12, ldc, c11, ldc, c12, ldc);  // U5 = U4 + P3
+  Sub(k2, n2, y, n2, b21, ldb, y, n2);        // T4
+  mul(a22, lda, y, n2, c11, ldc);             // P4
+  Sub(m2, n2, c21, ldc, c11, ldc, c21, ldc);  // U6 = U3 - P4
+  mul(a12, lda, b21, ldb, c11, ldc);          // P2
+  Add(m2, n2, x, n2, c11, ldc, c11, ldc);     // U1 = P1 + P2
+}
+
+}  // namespace
+
+std::size_t StrassenWorkspace(int m, int n, int k, int cutoff) {
+  std::size_t size = 0;
+  while (!IsLeaf(m, n, k, cutoff)) {
+    m /= 2;
+    n /= 2;
+    k /= 2;
+    size += static_cast<std::size_t>(m) * std::max(k, n) +
+            static_cast<std::size_t>(k) * n;
+  }
+  return size;
+}
+
+template <typename T>
+void StrassenGemm(int m, int n, int k, const T* a, int lda, const T* b,
+                  int ldb, T* c, int ldc, T* work, int cutoff) {
+  if (m < 1 || n < 1) {
+    return;
+  }
+  if (IsLeaf(m, n, k, cutoff)) {
+    ClassicGemm(m, n, k, a, lda, b, ldb, c, ldc);
+    return;
+  }
+  const int me = m & ~1, ne = n & ~1, ke = k & ~1;
+  Winograd(me, ne, ke, a, lda, b, ldb, c, ldc, work, cutoff);
+  // the peeled last column of A and row of B, then the last row and
+  // column of C
+  if (ke < k) {
+    Gemm(me, ne, 1, 1.0, a + ke, lda, 1,
+         b + static_cast<std::ptrdiff_t>(ke) * ldb, ldb, 1, c, ldc);
+  }
+  if (ne < n) {
+    ClassicGemm(m, 1, k, a, lda, b + ne, ldb, c + ne, ldc);
+  }
+  if (me < m) {
+    ClassicGemm(1, ne, k, a + static_cast<std::ptrdiff_t>(me) * lda, lda, b,
+                ldb, c + static_cast<std::ptrdiff_t>(me) * ldc, ldc);
+  }
+}
+
+template void StrassenGemm(int, int, int, const double*, int, const double*,
+                           int, double*, int, double*, int);
+template void StrassenGemm(int, int, int, const float*, int, const float*,
+                           int, float*, int, float*, int);
+
+}  // namespace s21
@@ -0,0 +1,32 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_STRASSEN_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_STRASSEN_H_
+
+#include <cstddef>
+
+namespace s21 {
+
+// Products whose smallest dimension is at most this go to s21::Gemm
+// instead of recursing further.
+constexpr int kStrassenCutoff = 256;
+
+// Elements of scratch StrassenGemm needs for an m x n x k product.
+std::size_t StrassenWorkspace(int m, int n, int k,
+                              int cutoff = kStrassenCutoff);
+
+// C(m x n) = A(m x k) * B(k x n) by the Strassen-Winograd recursion: 7
+// half-size products and 15 additions per level instead of 8 products.
+// Odd dimensions are peeled off and finished by s21::Gemm. All operands
+// are row-major with leading dimensions lda, ldb and ldc; work holds
+// StrassenWorkspace(m, n, k, cutoff) elements and no other memory is
+// allocated. The error is bounded normwise only, by about
+// (n / cutoff)^log2(18) times that of the classic product. T is double or
+// float.
+template <typename T>
+void StrassenGemm(int m, int n, int k, const T* a, int lda, const T* b,
+                  int ldb, T* c, int ldc, T* work,
+                  int cutoff = kStrassenCutoff);
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_STRASSEN_H_
@@ -0,0 +1,138 @@
+// created by pizpotli
+#include "s21_matrix_transpose.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_scalar.h"
+#include "s21_matrix_simd.h"
+
+namespace {
+
+// Recursion stops at tiles of at most this many elements: source and
+// destination tile together take 256 KiB and stay in L2, the register
+// kernel walks a tile one destination strip at a time.
+constexpr long kTileElements = 128 * 128;
+// In-place swaps go through a stack buffer of this many elements.
+constexpr long kSwapElements = 32 * 32;
+// Split points are kept on multiples of the widest register tile.
+constexpr int kSplitAlign = 8;
+
+int Half(int n) {
+  const int half = n / 2;
+  return half >= kSplitAlign ? half / kSplitAlign * kSplitAlign : half;
+}
+
+template <typename T>
+void CopyTile(const T* src, int rows, int cols, std::ptrdiff_t lds, T* dst,
+              std::ptrdiff_t ldd) {
+  if constexpr (s21::kWidened<T>) {
+    for (int j = 0; j < cols; j++) {
+      for (int i = 0; i < rows; i++) dst[j * ldd + i] = src[i * lds + j];
+    }
+  } else {
+    s21::simd::Active<T>().transpose(src, lds, dst, ldd, rows, cols);
+  }
+}
+
+// Exchanges the rows x cols block a with the transpose of the cols x rows
+// block b; a and b must not overlap.
+template <typename T>
+void SwapTransposed(T* a, T* b, int rows, int cols, std::ptrdiff_t ld) {
+  if (static_cast<long>(rows) * cols <= kSwapElements) {
+    T tile[kSwapElements];
+    CopyTile(a, rows, cols, ld, tile, rows);
+    CopyTile(b, cols, rows, ld, a, ld);
+    for (int i = 0; i < cols; i++) {
+      std::memcpy(b + i * ld, tile + i * rows, sizeof(T) * rows);
+    }
+  } else if (rows >= cols) {
+    const int half = Half(rows);
+    SwapTransposed(a, b, half, cols, ld);
+    SwapTransposed(a + half * ld, b + half, rows - half, cols, ld);
+  } else {
+    const int half = Half(cols);
+    SwapTransposed(a, b, rows, half, ld);
+    SwapTransposed(a + half, b + half * ld, rows, cols - half, ld);
+  }
+}
+
+}  // namespace
+
+namespace s21 {
+
+template <typename T>
+void TransposeCopy(const T* src, int rows, int cols, int lds, T* dst,
+                   int ldd) {
+  if (static_cast<long>(rows) * cols <= kTileElements) {
+    CopyTile(src, rows, cols, lds, dst, ldd);
+  } else if (rows >= cols) {
+    const int half = Half(rows);
+    TransposeCopy(src, half, cols, lds, dst, ldd);
+    TransposeCopy(src + static_cast<std::ptrdiff_t>(half) * lds, rows - half,
+                  cols, lds, dst + half, ldd);
+  } else {
+    const int half = Half(cols);
+    TransposeCopy(src, rows, half, lds, dst, ldd);
+    TransposeCopy(src + half, rows, cols - half, lds,
+                  dst + static_cast<std::ptrdiff_t>(half) * ldd, ldd);
+  }
+}
+
+template <typename T>
+void TransposeSquare(T* a, int n, int lda) {
+  if (static_cast<long>(n) * n <= kSwapElements) {
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        std::swap(a[i * lda + j], a[j * lda + i]);
+      }
+    }
+    return;
+  }
+  // [A11 A12; A21 A22]^T = [A11^T A21^T; A12^T A22^T]
+  const int half = Half(n);
+  const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(half) * lda;
+  TransposeSquare(a, half, lda);
+  TransposeSquare(a + offset + half, n - half, lda);
+  SwapTransposed(a + half, a + offset, half, n - half, lda);
+}
+
+template <typename T>
+void TransposeInPlace(T* a, int rows, int cols) {
+  if (rows == cols) {
+    TransposeSquare(a, rows, cols);
+    return;
+  }
+  if (rows == 1 || cols == 1) {
+    return;
+  }
+  // element k = i * cols + j moves to j * rows + i = k * rows mod (size - 1);
+  // the first and the last element stay
+  const std::uint64_t last = static_cast<std::uint64_t>(rows) * cols - 1;
+  std::vector<bool> moved(last);
+  for (std::uint64_t start = 1; start < last; start++) {
+    if (moved[start]) continue;
+    T carried = a[start];
+    std::uint64_t k = start;
+    do {
+      k = k * rows % last;
+      std::swap(carried, a[k]);
+      moved[k] = true;
+    } while (k != start);
+  }
+}
+
+template void TransposeCopy(const double*, int, int, int, double*, int);
+template void TransposeCopy(const float*, int, int, int, float*, int);
+template void TransposeCopy(const BFloat16*, int, int, int, BFloat16*, int);
+template void TransposeSquare(double*, int, int);
+template void TransposeSquare(float*, int, int);
+template void TransposeSquare(BFloat16*, int, int);
+template void TransposeInPlace(double*, int, int);
+template void TransposeInPlace(float*, int, int);
+template void TransposeInPlace(BFloat16*, int, int);
+
+}  // namespace s21
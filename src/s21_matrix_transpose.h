@@ -0,0 +1,28 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_TRANSPOSE_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_TRANSPOSE_H_
+
+namespace s21 {
+
+// dst (cols x rows, leading dimension ldd) = transpose of the rows x cols
+// row-major src. Recursively halves the longer side until a tile fits in
+// L2, so it is cache efficient at every level without tuning; tiles of
+// doubles and floats are transposed in SIMD registers. T is double, float
+// or BFloat16.
+template <typename T>
+void TransposeCopy(const T* src, int rows, int cols, int lds, T* dst,
+                   int ldd);
+
+// Transposes the n x n matrix a in place.
+template <typename T>
+void TransposeSquare(T* a, int n, int lda);
+
+// Transposes contiguous rows x cols storage in place by following the
+// cycles of the permutation; afterwards a holds the cols x rows transpose.
+// Needs one bit of scratch per element.
+template <typename T>
+void TransposeInPlace(T* a, int rows, int cols);
+
+}  // namespace s21
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_TRANSPOSE_H_
@@ -0,0 +1,174 @@
+// created by pizpotli
+#include "s21_matrix_view.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "s21_matrix_simd.h"
+#include "s21_matrix_transpose.h"
+
+namespace {
+
+std::ptrdiff_t Offset(int i, int j, int rs, int cs) {
+  return static_cast<std::ptrdiff_t>(i) * rs +
+         static_cast<std::ptrdiff_t>(j) * cs;
+}
+
+// Operand normalized to a rectangle of a row-major buffer with leading
+// dimension ld: transposed operands are described by their transpose.
+struct Rect {
+  std::uintptr_t begin;
+  std::uintptr_t end;
+  std::ptrdiff_t ld;
+  int rows, cols;
+  bool strided;
+
+  Rect(const double* p, int rs, int cs, int r, int c)
+      : begin(reinterpret_cast<std::uintptr_t>(p)),
+        end(reinterpret_cast<std::uintptr_t>(p + Offset(r - 1, c - 1, rs, cs) +
+                                             1)),
+        ld(cs == 1 ? rs : cs),
+        rows(cs == 1 ? r : c),
+        cols(cs == 1 ? c : r),
+        strided(cs != 1 && rs != 1) {}
+};
+
+bool Intersect(std::ptrdiff_t a0, std::ptrdiff_t a1, std::ptrdiff_t b0,
+               std::ptrdiff_t b1) {
+  return a0 < b1 && b0 < a1;
+}
+
+// False only if the two operands certainly share no element. Blocks of one
+// matrix are compared as rectangles, anything else by address range.
+bool MayAlias(const Rect& a, const Rect& b) {
+  if (a.end <= b.begin || b.end <= a.begin) {
+    return false;
+  }
+  if (a.strided || b.strided || a.ld != b.ld ||
+      a.begin % sizeof(double) != b.begin % sizeof(double)) {
+    return true;
+  }
+  const std::ptrdiff_t diff =
+      (static_cast<std::ptrdiff_t>(b.begin) -
+       static_cast<std::ptrdiff_t>(a.begin)) /
+      static_cast<std::ptrdiff_t>(sizeof(double));
+  // b starts at (row, col) relative to a, col in [0, ld); b may also have
+  // wrapped, i.e. start one row further at col - ld
+  std::ptrdiff_t row = diff / a.ld, col = diff % a.ld;
+  if (col < 0) {
+    col += a.ld;
+    row--;
+  }
+  for (int wrap = 0; wrap < 2; wrap++, row++, col -= a.ld) {
+    if (Intersect(0, a.rows, row, row + b.rows) &&
+        Intersect(0, a.cols, col, col + b.cols)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ApplyRow(s21::StridedOp op, double* dst, const double* src, int n) {
+  const s21::simd::Kernels& kernels = s21::simd::Active();
+  if (op == s21::StridedOp::kAdd) {
+    kernels.add(dst, src, n);
+  } else if (op == s21::StridedOp::kSub) {
+    kernels.sub(dst, src, n);
+  } else {
+    std::copy(src, src + n, dst);
+  }
+}
+
+double Combine(s21::StridedOp op, double dst, double src) {
+  if (op == s21::StridedOp::kAdd) return dst + src;
+  if (op == s21::StridedOp::kSub) return dst - src;
+  return src;
+}
+
+}  // namespace
+
+namespace s21 {
+
+void StridedApply(StridedOp op, double* dst, int rsd, int csd,
+                  const double* src, int rss, int css, int rows, int cols) {
+  const bool same_layout = dst == src && rsd == rss && csd == css;
+  if (!same_layout && MayAlias(Rect(dst, rsd, csd, rows, cols),
+                               Rect(src, rss, css, rows, cols))) {
+    S21Matrix copy(rows, cols);
+    StridedApply(StridedOp::kCopy, copy.data(), copy.stride(), 1, src, rss,
+                 css, rows, cols);
+    StridedApply(op, dst, rsd, csd, copy.data(), copy.stride(), 1, rows, cols);
+    return;
+  }
+  if (op == StridedOp::kCopy && csd == 1 && rss == 1) {
+    TransposeCopy(src, cols, rows, css, dst, rsd);
+    return;
+  }
+  for (int i = 0; i < rows; i++) {
+    double* d = dst + Offset(i, 0, rsd, csd);
+    const double* s = src + Offset(i, 0, rss, css);
+    if (csd == 1 && css == 1) {
+      ApplyRow(op, d, s, cols);
+    } else {
+      for (int j = 0; j < cols; j++) {
+        d[Offset(0, j, 0, csd)] =
+            Combine(op, d[Offset(0, j, 0, csd)], s[Offset(0, j, 0, css)]);
+      }
+    }
+  }
+}
+
+void StridedScale(double* dst, int rs, int cs, int rows, int cols,
+                  double num) {
+  for (int i = 0; i < rows; i++) {
+    double* d = dst + Offset(i, 0, rs, cs);
+    if (cs == 1) {
+      simd::Active().scale(d, num, cols);
+    } else {
+      for (int j = 0; j < cols; j++) d[Offset(0, j, 0, cs)] *= num;
+    }
+  }
+}
+
+bool StridedEqual(const double* a, int rsa, int csa, const double* b, int rsb,
+                  int csb, int rows, int cols, double eps) {
+  for (int i = 0; i < rows; i++) {
+    const double* x = a + Offset(i, 0, rsa, csa);
+    const double* y = b + Offset(i, 0, rsb, csb);
+    if (csa == 1 && csb == 1) {
+      if (!simd::Active().equal(x, y, cols, eps)) return false;
+    } else {
+      for (int j = 0; j < cols; j++) {
+        if (std::fabs(x[Offset(0, j, 0, csa)] - y[Offset(0, j, 0, csb)]) >
+            eps) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void StridedMulAdd(double* dst, int rsd, int csd, double alpha,
+                   const double* a, int rsa, int csa, const double* b,
+                   int rsb, int csb, int m, int n, int k) {
+  const Rect c_rect(dst, rsd, csd, m, n);
+  const bool aliased = MayAlias(c_rect, Rect(a, rsa, csa, m, k)) ||
+                       MayAlias(c_rect, Rect(b, rsb, csb, k, n));
+  if (csd == 1 && !aliased) {
+    Gemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, dst, rsd);
+  } else if (rsd == 1 && !aliased) {
+    // C^T += alpha * B^T * A^T with C^T row-major
+    Gemm(n, m, k, alpha, b, csb, rsb, a, csa, rsa, dst, csd);
+  } else {
+    S21Matrix product(m, n);
+    Gemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, product.data(),
+         product.stride());
+    StridedApply(StridedOp::kAdd, dst, rsd, csd, product.data(),
+                 product.stride(), 1, m, n);
+  }
+}
+
+}  // namespace s21
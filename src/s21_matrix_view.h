@@ -0,0 +1,206 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_VIEW_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_VIEW_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_oop.h"
+
+namespace s21 {
+
+// Strided kernels behind S21BasicMatrixView. Element (i, j) of an operand
+// lives at p[i * rs + j * cs]; overlapping operands are handled.
+enum class StridedOp { kCopy, kAdd, kSub };
+
+void StridedApply(StridedOp op, double* dst, int rsd, int csd,
+                  const double* src, int rss, int css, int rows, int cols);
+void StridedScale(double* dst, int rs, int cs, int rows, int cols,
+                  double num);
+bool StridedEqual(const double* a, int rsa, int csa, const double* b, int rsb,
+                  int csb, int rows, int cols, double eps);
+// dst += alpha * A(m x k) * B(k x n) for any dst strides
+void StridedMulAdd(double* dst, int rsd, int csd, double alpha,
+                   const double* a, int rsa, int csa, const double* b,
+                   int rsb, int csb, int m, int n, int k);
+
+}  // namespace s21
+
+// Non-owning window into the buffer of an S21Matrix (or any row-major
+// storage): rows x cols elements, element (i, j) at data()[i * RowStride()
+// + j * ColStride()]. Blocks, rows, columns and transposes are views again
+// and cost nothing; the viewed matrix must outlive the view and must not
+// be resized while it is in use. T is double or const double.
+template <typename T>
+class S21BasicMatrixView {
+  static_assert(std::is_same<std::remove_const_t<T>, double>::value,
+                "views are over double storage");
+
+  using Matrix = std::conditional_t<std::is_const<T>::value, const S21Matrix,
+                                    S21Matrix>;
+
+ public:
+  using ConstView = S21BasicMatrixView<const double>;
+
+  // Konstructors
+
+  // A mutable view of a matrix detaches its copy-on-write buffer first, so
+  // the conversion can throw std::bad_alloc; a read-only view cannot.
+  S21BasicMatrixView(Matrix& matrix) noexcept(  // NOLINT: implicit by design
+      std::is_const<T>::value)
+      : data_(matrix.data()),
+        rows_(matrix.GetRows()),
+        cols_(matrix.GetCols()),
+        rs_(matrix.stride()),
+        cs_(1) {}
+  S21BasicMatrixView(T* data, int rows, int cols, int row_stride,
+                     int col_stride = 1) noexcept
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        rs_(row_stride),
+        cs_(col_stride) {}
+  // a mutable view converts to a read-only one
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same<const U, T>::value &&
+                            !std::is_same<U, T>::value>>
+  S21BasicMatrixView(const S21BasicMatrixView<U>& other) noexcept
+      : data_(other.data()),
+        rows_(other.GetRows()),
+        cols_(other.GetCols()),
+        rs_(other.RowStride()),
+        cs_(other.ColStride()) {}
+
+  // Slicing
+
+  S21BasicMatrixView Block(int row, int col, int rows, int cols) const {
+    if (row < 0 || col < 0 || rows < 1 || cols < 1 || row + rows > rows_ ||
+        col + cols > cols_) {
+      throw std::out_of_range("ERROR: index outside matrix");
+    }
+    return {data_ + static_cast<std::ptrdiff_t>(row) * rs_ +
+                static_cast<std::ptrdiff_t>(col) * cs_,
+            rows, cols, rs_, cs_};
+  }
+  S21BasicMatrixView Row(int i) const { return Block(i, 0, 1, cols_); }
+  S21BasicMatrixView Col(int j) const { return Block(0, j, rows_, 1); }
+  S21BasicMatrixView TransposedView() const noexcept {
+    return {data_, cols_, rows_, cs_, rs_};
+  }
+
+  // Arithmetics
+
+  void SumMatrix(const ConstView& other) const {
+    Apply(s21::StridedOp::kAdd, other);
+  }
+  void SubMatrix(const ConstView& other) const {
+    Apply(s21::StridedOp::kSub, other);
+  }
+  // copies the values of other into the viewed elements
+  void Assign(const ConstView& other) const {
+    Apply(s21::StridedOp::kCopy, other);
+  }
+  void MulNumber(const double num) const {
+    static_assert(!std::is_const<T>::value, "read-only view");
+    s21::StridedScale(data_, rs_, cs_, rows_, cols_, num);
+  }
+  // this += alpha * a * b, e.g. the trailing update of a block algorithm
+  void MulAdd(const ConstView& a, const ConstView& b,
+              double alpha = 1.0) const {
+    static_assert(!std::is_const<T>::value, "read-only view");
+    if (a.GetCols() != b.GetRows()) {
+      throw std::out_of_range("ERROR: sides are not equal");
+    }
+    if (a.GetRows() != rows_ || b.GetCols() != cols_) {
+      throw std::out_of_range("ERROR: different dimensions of matrices");
+    }
+    s21::StridedMulAdd(data_, rs_, cs_, alpha, a.data(), a.RowStride(),
+                       a.ColStride(), b.data(), b.RowStride(), b.ColStride(),
+                       rows_, cols_, a.GetCols());
+  }
+  bool EqMatrix(const ConstView& other) const noexcept {
+    return rows_ == other.GetRows() && cols_ == other.GetCols() &&
+           s21::StridedEqual(data_, rs_, cs_, other.data(), other.RowStride(),
+                             other.ColStride(), rows_, cols_, 1e-6);
+  }
+
+  // operators: results are new matrices
+
+  S21Matrix operator+(const ConstView& other) const {
+    S21Matrix res = ToMatrix();
+    S21BasicMatrixView<double>(res).SumMatrix(other);
+    return res;
+  }
+  S21Matrix operator-(const ConstView& other) const {
+    S21Matrix res = ToMatrix();
+    S21BasicMatrixView<double>(res).SubMatrix(other);
+    return res;
+  }
+  S21Matrix operator*(const ConstView& other) const {
+    S21Matrix res(rows_, other.GetCols());
+    S21BasicMatrixView<double>(res).MulAdd(*this, other);
+    return res;
+  }
+  S21Matrix operator*(const double number) const {
+    S21Matrix res = ToMatrix();
+    S21BasicMatrixView<double>(res).MulNumber(number);
+    return res;
+  }
+  bool operator==(const ConstView& other) const noexcept {
+    return EqMatrix(other);
+  }
+  const S21BasicMatrixView& operator+=(const ConstView& other) const {
+    SumMatrix(other);
+    return *this;
+  }
+  const S21BasicMatrixView& operator-=(const ConstView& other) const {
+    SubMatrix(other);
+    return *this;
+  }
+  const S21BasicMatrixView& operator*=(const double number) const {
+    MulNumber(number);
+    return *this;
+  }
+
+  T& operator()(const int x, const int y) const {
+    if (x >= rows_ || y >= cols_ || x < 0 || y < 0) {
+      throw std::out_of_range("ERROR: index outside matrix");
+    }
+    return data_[static_cast<std::ptrdiff_t>(x) * rs_ +
+                 static_cast<std::ptrdiff_t>(y) * cs_];
+  }
+
+  S21Matrix ToMatrix() const {
+    S21Matrix res(rows_, cols_);
+    S21BasicMatrixView<double>(res).Assign(*this);
+    return res;
+  }
+
+  // Accessors
+
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  int RowStride() const noexcept { return rs_; }
+  int ColStride() const noexcept { return cs_; }
+  T* data() const noexcept { return data_; }
+
+ private:
+  T* data_;
+  int rows_, cols_, rs_, cs_;
+
+  void Apply(s21::StridedOp op, const ConstView& other) const {
+    static_assert(!std::is_const<T>::value, "read-only view");
+    if (rows_ != other.GetRows() || cols_ != other.GetCols()) {
+      throw std::out_of_range("ERROR: different dimensions of matrices");
+    }
+    s21::StridedApply(op, data_, rs_, cs_, other.data(), other.RowStride(),
+                      other.ColStride(), rows_, cols_);
+  }
+};
+
+using S21MatrixView = S21BasicMatrixView<double>;
+using S21ConstMatrixView = S21BasicMatrixView<const double>;
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_MATRIX_VIEW_H_
@@ -0,0 +1,149 @@
+// created by pizpotli
+#include "s21_task_graph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+struct S21TaskGraph::Queue {
+  std::mutex mutex;
+  std::deque<int> ready;
+
+  void Push(int task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.push_back(task);
+  }
+
+  // newest task for the owner, oldest for a thief; -1 if empty
+  int Pop(bool owner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ready.empty()) {
+      return -1;
+    }
+    int task;
+    if (owner) {
+      task = ready.back();
+      ready.pop_back();
+    } else {
+      task = ready.front();
+      ready.pop_front();
+    }
+    return task;
+  }
+};
+
+// ACCESSORS
+
+int S21TaskGraph::GetTasks() const noexcept {
+  return static_cast<int>(tasks_.size());
+}
+
+// MUTATORS
+
+int S21TaskGraph::Add(std::function<void()> work,
+                      const std::vector<int>& after) {
+  const int id = static_cast<int>(tasks_.size());
+  tasks_.push_back({std::move(work), {}, 0});
+  for (int before : after) {
+    if (before >= 0) {
+      tasks_[before].next.push_back(id);
+      tasks_[id].waits++;
+    }
+  }
+  return id;
+}
+
+// PARALLEL
+
+void S21TaskGraph::Run(S21ThreadPool& pool) {
+  const int count = GetTasks();
+  if (count == 0) {
+    return;
+  }
+  const int threads = std::min(pool.GetThreads(), count);
+  std::vector<Queue> queues(threads);
+  std::unique_ptr<std::atomic<int>[]> waits(new std::atomic<int>[count]);
+  int initial = 0;
+  for (int task = 0; task < count; task++) {
+    waits[task] = tasks_[task].waits;
+    if (tasks_[task].waits == 0) {
+      queues[initial++ % threads].ready.push_back(task);
+    }
+  }
+  std::atomic<int> remaining{count};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  // Threads without a task sleep on parked until a task becomes ready or
+  // the graph is done. ready counts the queued tasks and sleepers the
+  // threads that may be waiting; both are sequentially consistent, so a
+  // push either sees a sleeper and wakes it or the sleeper sees the task.
+  std::atomic<int> ready{initial}, sleepers{0};
+  std::mutex park_mutex;
+  std::condition_variable parked;
+
+  auto wake = [&](bool all) {
+    if (sleepers.load() > 0) {
+      { std::lock_guard<std::mutex> lock(park_mutex); }
+      if (all) {
+        parked.notify_all();
+      } else {
+        parked.notify_one();
+      }
+    }
+  };
+  auto next_task = [&](int self) {
+    int task = queues[self].Pop(true);
+    for (int i = 1; task < 0 && i < threads; i++) {
+      task = queues[(self + i) % threads].Pop(false);
+    }
+    if (task >= 0) ready.fetch_sub(1);
+    return task;
+  };
+  auto work = [&](int self) {
+    while (remaining.load(std::memory_order_acquire) > 0) {
+      const int task = next_task(self);
+      if (task < 0) {
+        std::unique_lock<std::mutex> lock(park_mutex);
+        sleepers.fetch_add(1);
+        parked.wait(lock,
+                    [&] { return ready.load() > 0 || remaining.load() == 0; });
+        sleepers.fetch_sub(1);
+        continue;
+      }
+      if (!failed.load(std::memory_order_relaxed)) {
+        try {
+          tasks_[task].work();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) error = std::current_exception();
+          failed = true;
+        }
+      }
+      for (int next : tasks_[task].next) {
+        if (waits[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          queues[self].Push(next);
+          ready.fetch_add(1);
+          wake(false);
+        }
+      }
+      if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        wake(true);
+      }
+    }
+  };
+  // one chunk per queue; a thread that gets several serves them in turn,
+  // the first one until the whole graph is done
+  pool.ParallelFor(threads, 1, [&](int begin, int end) {
+    for (int self = begin; self < end; self++) work(self);
+  });
+  tasks_.clear();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,41 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_TASK_GRAPH_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_TASK_GRAPH_H_
+
+#include <functional>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+// Directed acyclic graph of tasks, run on the threads of an S21ThreadPool.
+// A task starts as soon as the tasks it was added after have finished, so
+// the independent parts of a tiled algorithm overlap instead of meeting at
+// a barrier after every step. Each thread keeps its ready tasks in a deque
+// of its own, runs the newest one first (its inputs are likely still in
+// cache) and steals the oldest one of another thread when it runs dry;
+// threads that find nothing to steal sleep until a task becomes ready.
+class S21TaskGraph {
+ public:
+  // Adds work to be run after every task in after and returns its id.
+  // Negative ids in after are ignored, so -1 can stand for "no task".
+  int Add(std::function<void()> work, const std::vector<int>& after = {});
+  // Runs every task and returns when all have finished; the graph is empty
+  // afterwards. The first exception thrown by a task is rethrown here and
+  // the tasks not yet started are skipped. Called from inside a pool task,
+  // the graph runs on the calling thread only.
+  void Run(S21ThreadPool& pool = S21ThreadPool::Global());
+
+  int GetTasks() const noexcept;
+
+ private:
+  struct Task {
+    std::function<void()> work;
+    std::vector<int> next;
+    int waits;
+  };
+  struct Queue;
+
+  std::vector<Task> tasks_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_TASK_GRAPH_H_
@@ -0,0 +1,150 @@
+// created by pizpotli
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace {
+
+thread_local bool in_parallel_region = false;
+
+}  // namespace
+
+struct S21ThreadPool::Job {
+  const std::function<void(int, int)>* body;
+  int count;
+  int chunk;
+  int chunks;
+  std::atomic<int> next{0};
+  std::atomic<int> finished{0};
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable done;
+
+  // Runs one chunk; returns false once every chunk has been claimed.
+  bool RunChunk() {
+    const int index = next.fetch_add(1);
+    if (index >= chunks) {
+      return false;
+    }
+    const int begin = index * chunk;
+    try {
+      (*body)(begin, std::min(count, begin + chunk));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) error = std::current_exception();
+    }
+    if (finished.fetch_add(1) + 1 == chunks) {
+      std::lock_guard<std::mutex> lock(mutex);
+      done.notify_all();
+    }
+    return true;
+  }
+};
+
+// KONSTRUCTORS
+
+S21ThreadPool::S21ThreadPool(int threads) : stop_(false) { Start(threads); }
+
+S21ThreadPool::~S21ThreadPool() { Stop(); }
+
+// ACCESSORS
+
+int S21ThreadPool::GetThreads() const noexcept {
+  return static_cast<int>(workers_.size()) + 1;
+}
+
+S21ThreadPool& S21ThreadPool::Global() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+// MUTATORS
+
+void S21ThreadPool::Resize(int threads) {
+  Stop();
+  Start(threads);
+}
+
+// PARALLEL
+
+void S21ThreadPool::ParallelFor(int count, int grain,
+                                const std::function<void(int, int)>& body) {
+  if (count < 1) {
+    return;
+  }
+  grain = std::max(grain, 1);
+  const int threads = GetThreads();
+  if (workers_.empty() || in_parallel_region || count <= grain) {
+    body(0, count);
+    return;
+  }
+  auto job = std::make_shared<Job>();
+  job->body = &body;
+  job->count = count;
+  // a few chunks per thread keeps the load balanced without tiny chunks
+  job->chunk = std::max(grain, (count + threads * 4 - 1) / (threads * 4));
+  job->chunks = (count + job->chunk - 1) / job->chunk;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+  }
+  wake_.notify_all();
+  in_parallel_region = true;
+  while (job->RunChunk()) {
+  }
+  in_parallel_region = false;
+  {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->done.wait(lock, [&] { return job->finished == job->chunks; });
+  }
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+}
+
+// HELP FUNCTIONS
+
+void S21ThreadPool::Start(int threads) {
+  if (threads < 1) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  stop_ = false;
+  for (int i = 1; i < threads; i++) {
+    workers_.emplace_back(&S21ThreadPool::WorkerLoop, this);
+  }
+}
+
+void S21ThreadPool::Stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void S21ThreadPool::WorkerLoop() {
+  in_parallel_region = true;
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      if (stop_) {
+        return;
+      }
+      job = jobs_.front();
+    }
+    if (!job->RunChunk()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!jobs_.empty() && jobs_.front() == job) {
+        jobs_.pop_front();
+      }
+    }
+  }
+}
@@ -0,0 +1,51 @@
+// created by pizpotli
+#ifndef CPP1_S21_MATRIXPLUS_3_SRC_S21_THREAD_POOL_H_
+#define CPP1_S21_MATRIXPLUS_3_SRC_S21_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join pool used by the matrix kernels. The calling thread always
+// takes part in the work, so a pool of n threads starts n - 1 workers.
+class S21ThreadPool {
+ public:
+  // threads < 1 means std::thread::hardware_concurrency()
+  explicit S21ThreadPool(int threads = 0);
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+  ~S21ThreadPool();
+
+  int GetThreads() const noexcept;
+  // Must not be called while a ParallelFor is running on this pool.
+  void Resize(int threads);
+
+  // Calls body(begin, end) on disjoint chunks of [0, count) of at least
+  // grain items and returns when all of them finished. The first exception
+  // thrown by body is rethrown here. Nested calls from inside a body run
+  // serially on the calling thread.
+  void ParallelFor(int count, int grain,
+                   const std::function<void(int, int)>& body);
+
+  // Pool shared by all S21Matrix operations.
+  static S21ThreadPool& Global();
+
+ private:
+  struct Job;
+
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Job>> jobs_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stop_;
+
+  void Start(int threads);
+  void Stop() noexcept;
+  void WorkerLoop();
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_3_SRC_S21_THREAD_POOL_H_
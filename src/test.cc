@@ -1,7 +1,62 @@
 // created by pizpotli
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_batch.h"
+#include "s21_matrix_decomposition.h"
+#include "s21_matrix_expr.h"
+#include "s21_matrix_fixed.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_lu.h"
+#include "s21_matrix_memory.h"
+#include "s21_matrix_out_of_core.h"
+#include "s21_matrix_view.h"
 #include "s21_matrix_oop.h"
+#include "s21_matrix_scalar.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_sparse.h"
+#include "s21_matrix_stats.h"
+#include "s21_matrix_strassen.h"
+#include "s21_task_graph.h"
+#include "s21_thread_pool.h"
+
+// Matrix buffers are aligned array allocations; counting them lets the
+// tests check how many buffers an expression creates.
+static std::atomic<int> aligned_allocations{0};
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  aligned_allocations++;
+  const std::size_t alignment = static_cast<std::size_t>(align);
+  void* ptr = std::aligned_alloc(
+      alignment, (size + alignment - 1) / alignment * alignment);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
 
 //********** EQMATRIX **********
 
@@ -207,6 +262,121 @@ TEST(MulMatrix, mul2) {
   EXPECT_ANY_THROW(a.MulMatrix(b));
 }
 
+TEST(MulMatrix, blocked_matches_reference) {
+  const int m = 131, k = 301, n = 67;
+  S21Matrix a(m, k);
+  S21Matrix b(k, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < k; j++) a(i, j) = (i * 7 + j * 3) % 11 - 5.0;
+  }
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) b(i, j) = (i * 5 + j) % 13 * 0.5 - 3.0;
+  }
+  S21Matrix expected(m, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double sum = 0;
+      for (int p = 0; p < k; p++) sum += a(i, p) * b(p, j);
+      expected(i, j) = sum;
+    }
+  }
+  a.MulMatrix(b);
+  EXPECT_EQ(a.GetRows(), m);
+  EXPECT_EQ(a.GetCols(), n);
+  EXPECT_TRUE(a == expected);
+}
+
+// uniform in [-1, 1), the same sequence on every platform
+static S21Matrix Uniform(int rows, int cols, unsigned seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      seed = seed * 1664525u + 1013904223u;
+      m(i, j) = seed / 2147483648.0 - 1;
+    }
+  }
+  return m;
+}
+
+static S21Matrix Strassen(const S21Matrix& a, const S21Matrix& b,
+                          int cutoff) {
+  const int m = a.GetRows(), n = b.GetCols(), k = a.GetCols();
+  S21Matrix c(m, n);
+  std::vector<double> work(s21::StrassenWorkspace(m, n, k, cutoff));
+  s21::StrassenGemm(m, n, k, a.data(), a.stride(), b.data(), b.stride(),
+                    c.data(), c.stride(), work.data(), cutoff);
+  return c;
+}
+
+TEST(MulMatrix, strassen_peels_odd_shapes) {
+  const int shapes[][3] = {{64, 64, 64}, {37, 29, 53}, {65, 130, 33},
+                           {1, 40, 40}, {40, 40, 1}};
+  for (const auto& shape : shapes) {
+    S21Matrix a(shape[0], shape[2]), b(shape[2], shape[1]);
+    for (int i = 0; i < a.GetRows(); i++) {
+      for (int j = 0; j < a.GetCols(); j++) a(i, j) = (i * 7 + j * 3) % 11 - 5;
+    }
+    for (int i = 0; i < b.GetRows(); i++) {
+      for (int j = 0; j < b.GetCols(); j++) b(i, j) = (i * 5 + j) % 13 - 6;
+    }
+    // integer products and sums are exact, so every schedule agrees
+    const S21Matrix expected = a * b;
+    for (int cutoff : {1, 4, 16}) {
+      EXPECT_TRUE(Strassen(a, b, cutoff) == expected);
+    }
+  }
+}
+
+// Classic multiplication satisfies |C - AB| <= n u |A| |B| elementwise.
+// Strassen-Winograd with l levels above n0 x n0 products only satisfies
+// the normwise bound (Higham, Accuracy and Stability of Numerical
+// Algorithms, 23.2.2)
+//   max |C - AB| <= ((n / n0)^log2(18) (n0^2 + 6 n0) - 6 n) u max|A| max|B|
+// which grows by 18 per level rather than by 2.
+TEST(MulMatrix, strassen_error_bound) {
+  const int n = 96, n0 = 12;
+  S21Matrix a = Uniform(n, n, 1), b = Uniform(n, n, 2);
+  S21Matrix classic = a * b, fast = Strassen(a, b, n0);
+  const double u = std::numeric_limits<double>::epsilon() / 2;
+  // classic error over its elementwise bound, Strassen's largest error
+  double classic_ratio = 0, fast_error = 0;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      long double exact = 0, magnitude = 0;
+      for (int p = 0; p < n; p++) {
+        exact += static_cast<long double>(a(i, p)) * b(p, j);
+        magnitude += std::fabs(a(i, p) * b(p, j));
+      }
+      classic_ratio = std::max(
+          classic_ratio,
+          static_cast<double>(std::fabs(classic(i, j) - exact) /
+                              (n * u * magnitude)));
+      fast_error = std::max(
+          fast_error, static_cast<double>(std::fabs(fast(i, j) - exact)));
+    }
+  }
+  // max |A| and max |B| are below 1
+  const double fast_bound =
+      (std::pow(n / n0, std::log2(18.0)) * (n0 * n0 + 6 * n0) - 6 * n) * u;
+  EXPECT_LE(classic_ratio, 1);
+  EXPECT_LE(fast_error, fast_bound);
+  EXPECT_GT(fast_error, 0);
+}
+
+TEST(MulMatrix, strassen_member) {
+  S21Matrix a = Uniform(600, 520, 3);
+  const S21Matrix b = Uniform(520, 301, 4), expected = a * b;
+  a.MulMatrixStrassen(b);
+  EXPECT_EQ(a.GetRows(), 600);
+  EXPECT_EQ(a.GetCols(), 301);
+  EXPECT_TRUE(a == expected);
+  const S21MatrixF f(Uniform(3, 3, 5));
+  S21MatrixF g(f);
+  g.MulMatrixStrassen(f);
+  EXPECT_TRUE(g == f * f);
+  EXPECT_THROW(a.MulMatrixStrassen(b), std::out_of_range);
+}
+
 //********** DETERMINANT **********
 
 TEST(Determinant, determinant1) {
@@ -251,6 +421,22 @@ TEST(Determinant, determinant4) {
   EXPECT_ANY_THROW(exception.Determinant());
 }
 
+TEST(Determinant, needs_pivoting) {
+  S21Matrix a(3, 3);
+  a(0, 1) = 2;
+  a(1, 0) = 3;
+  a(2, 2) = 4;
+  EXPECT_DOUBLE_EQ(a.Determinant(), -24);
+}
+
+TEST(Determinant, singular) {
+  S21Matrix a(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) a(i, j) = i * 3 + j + 1;
+  }
+  EXPECT_NEAR(a.Determinant(), 0, 1e-12);
+}
+
 //********** TRANSPOSE **********
 
 TEST(Transpose, test1) {
@@ -299,6 +485,55 @@ TEST(Transpose, test2) {
 
 //********** CALCCOMPLEMENTS **********
 
+TEST(CalcComplements, nonsingular) {
+  S21Matrix a(3, 3);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(0, 2) = 3;
+  a(1, 0) = 0;
+  a(1, 1) = 4;
+  a(1, 2) = 2;
+  a(2, 0) = 5;
+  a(2, 1) = 2;
+  a(2, 2) = 1;
+  S21Matrix expected(3, 3);
+  expected(0, 0) = 0;
+  expected(0, 1) = 10;
+  expected(0, 2) = -20;
+  expected(1, 0) = 4;
+  expected(1, 1) = -14;
+  expected(1, 2) = 8;
+  expected(2, 0) = -8;
+  expected(2, 1) = -2;
+  expected(2, 2) = 4;
+  EXPECT_TRUE(a.CalcComplements() == expected);
+}
+
+TEST(CalcComplements, singular) {
+  S21Matrix a(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) a(i, j) = i * 3 + j + 1;
+  }
+  S21Matrix expected(3, 3);
+  expected(0, 0) = -3;
+  expected(0, 1) = 6;
+  expected(0, 2) = -3;
+  expected(1, 0) = 6;
+  expected(1, 1) = -12;
+  expected(1, 2) = 6;
+  expected(2, 0) = -3;
+  expected(2, 1) = 6;
+  expected(2, 2) = -3;
+  EXPECT_TRUE(a.CalcComplements() == expected);
+}
+
+TEST(CalcComplements, one_by_one) {
+  S21Matrix a(1, 1);
+  a(0, 0) = 5;
+  S21Matrix result = a.CalcComplements();
+  EXPECT_DOUBLE_EQ(result(0, 0), 1);
+}
+
 //********** INVERSE **********
 
 TEST(Inverse, False) {
@@ -414,6 +649,18 @@ TEST(Inverse, false2) {
   EXPECT_ANY_THROW(exception.InverseMatrix());
 }
 
+TEST(Inverse, large_blocked) {
+  const int n = 150;
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = ((i * 31 + j * 17) % 23) / 23.0;
+    a(i, i) += n / 4.0;
+  }
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  EXPECT_TRUE(a * a.InverseMatrix() == identity);
+}
+
 //********** OPERATOR + **********
 
 TEST(OperatorPlus, plus1) {
@@ -777,6 +1024,60 @@ TEST(Operator, brakets_Exception) {
   EXPECT_ANY_THROW(exception(1, 5));
 }
 
+TEST(Operator, const_and_unchecked_access) {
+  S21Matrix basic(2, 3);
+  basic.UncheckedAt(1, 2) = 4;
+  basic.At(0, 1) = 5;
+  const S21Matrix& view = basic;
+  EXPECT_EQ(view(1, 2), 4);
+  EXPECT_EQ(view.At(0, 1), 5);
+  EXPECT_EQ(view.UncheckedAt(1, 2), 4);
+  EXPECT_THROW(view(2, 0), std::out_of_range);
+  EXPECT_THROW(view.At(0, -1), std::out_of_range);
+  EXPECT_THROW(basic.At(0, 3), std::out_of_range);
+}
+
+TEST(Operator, element_iterators) {
+  S21Matrix a(3, 4);
+  std::iota(a.begin(), a.end(), 1.0);
+  EXPECT_EQ(a(2, 3), 12);
+  EXPECT_EQ(std::accumulate(a.cbegin(), a.cend(), 0.0), 78);
+  for (double& x : a) x *= 2;
+  const S21Matrix& b = a;
+  EXPECT_EQ(*std::max_element(b.begin(), b.end()), 24);
+  EXPECT_EQ(b.end() - b.begin(), 12);
+  S21Matrix empty;
+  EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(Operator, row_iterators) {
+  S21Matrix a(3, 4);
+  std::iota(a.begin(), a.end(), 0.0);
+  int i = 0;
+  for (s21::MatrixRow<double> row : a.Rows()) {
+    EXPECT_EQ(row.size(), 4);
+    EXPECT_EQ(row[1], a(i, 1));
+    std::reverse(row.begin(), row.end());
+    i++;
+  }
+  EXPECT_EQ(i, 3);
+  EXPECT_EQ(a(0, 0), 3);
+  const S21Matrix& b = a;
+  const auto rows = b.Rows();
+  EXPECT_EQ(std::distance(rows.begin(), rows.end()), 3);
+  EXPECT_EQ(rows.begin()[2][3], 8);
+  EXPECT_EQ((*(rows.end() - 1))[0], 11);
+  auto it = rows.begin();
+  it += 2;
+  EXPECT_TRUE(it > rows.begin() && it - rows.begin() == 2);
+  auto widest = std::max_element(
+      rows.begin(), rows.end(),
+      [](s21::MatrixRow<const double> x, s21::MatrixRow<const double> y) {
+        return x[0] < y[0];
+      });
+  EXPECT_EQ(widest - rows.begin(), 2);
+}
+
 //********** Get and SET **********
 
 TEST(GetterAndSetter, set_rows_0) {
@@ -1022,6 +1323,1395 @@ TEST(Constructors, braket_Exception2) {
   EXPECT_ANY_THROW(exception(5, 0) = 5);
 }
 
+//********** DECOMPOSITIONS **********
+
+static S21Matrix SpdMatrix(int n) {
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = 1.0 / (1 + i + j);
+    a(i, i) += n;
+  }
+  return a;
+}
+
+static S21Matrix RightSide(int rows, int cols) {
+  S21Matrix b(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) b(i, j) = (i * 3 + j * 5) % 7 - 3.0;
+  }
+  return b;
+}
+
+TEST(Decomposition, lu_solve) {
+  S21Matrix a(3, 3);
+  a(0, 1) = 2;
+  a(0, 2) = 1;
+  a(1, 0) = 3;
+  a(1, 1) = -1;
+  a(2, 0) = 1;
+  a(2, 1) = 1;
+  a(2, 2) = 4;
+  S21LU lu(a);
+  S21Matrix b = RightSide(3, 4);
+  S21Matrix column = RightSide(3, 1);
+  EXPECT_TRUE(a * lu.Solve(b) == b);
+  EXPECT_TRUE(a * lu.Solve(column) == column);
+  EXPECT_DOUBLE_EQ(lu.Determinant(), a.Determinant());
+  EXPECT_TRUE(lu.Inverse() == a.InverseMatrix());
+  lu.SolveInPlace(b);
+  EXPECT_TRUE(b == lu.Solve(RightSide(3, 4)));
+}
+
+TEST(Decomposition, lu_errors) {
+  EXPECT_THROW(S21LU(S21Matrix(2, 3)), std::out_of_range);
+  S21LU singular{S21Matrix(2, 2)};
+  EXPECT_DOUBLE_EQ(singular.Determinant(), 0);
+  EXPECT_THROW(singular.Inverse(), std::out_of_range);
+  S21LU lu{SpdMatrix(3)};
+  EXPECT_THROW(lu.Solve(S21Matrix(2, 1)), std::out_of_range);
+}
+
+static S21Matrix Hilbert(int n) {
+  S21Matrix h(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) h(i, j) = 1.0 / (i + j + 1);
+  }
+  return h;
+}
+
+static double Norm1(const S21Matrix& a) {
+  return s21::Norm1(a.data(), a.GetRows(), a.GetCols(), a.stride());
+}
+
+TEST(Decomposition, lu_full_pivoting) {
+  const S21Matrix a = SpdMatrix(9) + RightSide(9, 9);
+  const S21LU partial(a), full(a, S21LU::Pivoting::kFull);
+  const S21Matrix b = RightSide(9, 2);
+  EXPECT_TRUE(a * full.Solve(b) == b);
+  EXPECT_TRUE(full.Inverse() == partial.Inverse());
+  EXPECT_NEAR(full.Determinant() / partial.Determinant(), 1, 1e-12);
+  EXPECT_EQ(full.Rank(), 9);
+  // rows 3 and 4 are combinations of rows 0 to 2
+  S21Matrix deficient = RightSide(5, 5);
+  for (int j = 0; j < 5; j++) {
+    deficient(0, j) += j * j;
+    deficient(3, j) = deficient(0, j) - 2 * deficient(1, j);
+    deficient(4, j) = deficient(1, j) + 0.5 * deficient(2, j);
+  }
+  const S21LU rank_revealing(deficient, S21LU::Pivoting::kFull);
+  EXPECT_EQ(rank_revealing.Rank(), 3);
+  EXPECT_TRUE(rank_revealing.IsSingular());
+  EXPECT_THROW(rank_revealing.Solve(RightSide(5, 1)), std::out_of_range);
+  EXPECT_THROW(deficient.InverseMatrix(), std::out_of_range);
+}
+
+TEST(Decomposition, condition_number) {
+  S21Matrix diagonal(3, 3);
+  diagonal(0, 0) = 1;
+  diagonal(1, 1) = 1e-3;
+  diagonal(2, 2) = -10;
+  EXPECT_NEAR(S21LU(diagonal).ConditionNumber(), 1e4, 1e-8);
+  for (int n : {4, 8}) {
+    const S21Matrix h = Hilbert(n);
+    const double exact = Norm1(h) * Norm1(h.InverseMatrix());
+    const double estimate = S21LU(h).ConditionNumber();
+    EXPECT_LE(estimate, exact * (1 + 1e-6));
+    EXPECT_GE(estimate, exact / 3);
+  }
+  EXPECT_FALSE(S21LU(Hilbert(8)).IsSingular());
+  // cond ~ 1e18 is beyond double precision however large det is
+  const S21Matrix h = Hilbert(13) * 1e20;
+  EXPECT_TRUE(S21LU(h).IsSingular());
+  EXPECT_THROW(h.InverseMatrix(), std::out_of_range);
+  EXPECT_EQ(S21LU(S21Matrix(2, 2)).ConditionNumber(),
+            std::numeric_limits<double>::infinity());
+}
+
+TEST(Decomposition, singularity_ignores_scale) {
+  // det = 1e-12, but perfectly conditioned
+  S21Matrix small(4, 4), expected(4, 4);
+  for (int i = 0; i < 4; i++) {
+    small(i, i) = 1e-3;
+    expected(i, i) = 1e3;
+  }
+  EXPECT_TRUE(small.InverseMatrix() == expected);
+  EXPECT_TRUE(small.CalcComplements() == expected * 1e-12);
+  using Fixed4 = S21FixedMatrix<4, 4>;
+  using Fixed6 = S21FixedMatrix<6, 6>;
+  EXPECT_TRUE(Fixed4(small).InverseMatrix() == Fixed4(expected));
+  S21Matrix small6(6, 6);
+  for (int i = 0; i < 6; i++) small6(i, i) = 1e-3;
+  EXPECT_NO_THROW(Fixed6(small6).InverseMatrix());
+  S21MatrixBatch batch(3, 4, 4);
+  for (int i = 0; i < 3; i++) batch.Set(i, small);
+  EXPECT_TRUE(batch.InverseMatrix().Get(2) == expected);
+}
+
+TEST(Decomposition, cholesky) {
+  S21Matrix a = SpdMatrix(20);
+  S21Cholesky cholesky(a);
+  S21Matrix b = RightSide(20, 3);
+  EXPECT_TRUE(a * cholesky.Solve(b) == b);
+  EXPECT_NEAR(cholesky.Determinant() / a.Determinant(), 1, 1e-12);
+  EXPECT_TRUE(cholesky.Inverse() == a.InverseMatrix());
+}
+
+TEST(Decomposition, cholesky_not_positive_definite) {
+  S21Matrix a(2, 2);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(1, 0) = 2;
+  a(1, 1) = 1;
+  EXPECT_THROW(S21Cholesky{a}, std::out_of_range);
+}
+
+TEST(Decomposition, qr_square) {
+  S21Matrix a = RightSide(5, 5);
+  a(0, 0) = 10;
+  S21QR qr(a);
+  S21Matrix b = RightSide(5, 2);
+  EXPECT_TRUE(a * qr.Solve(b) == b);
+  EXPECT_NEAR(qr.Determinant(), a.Determinant(), 1e-9);
+  EXPECT_TRUE(qr.Inverse() == a.InverseMatrix());
+}
+
+TEST(Decomposition, qr_least_squares) {
+  // y = 2 + 3x sampled without noise, so the fit is exact
+  S21Matrix a(6, 2);
+  S21Matrix y(6, 1);
+  for (int i = 0; i < 6; i++) {
+    a(i, 0) = 1;
+    a(i, 1) = i;
+    y(i, 0) = 2 + 3 * i;
+  }
+  S21QR qr(a);
+  S21Matrix x = qr.Solve(y);
+  EXPECT_EQ(x.GetRows(), 2);
+  EXPECT_NEAR(x(0, 0), 2, 1e-12);
+  EXPECT_NEAR(x(1, 0), 3, 1e-12);
+  EXPECT_THROW(qr.Determinant(), std::out_of_range);
+}
+
+TEST(Decomposition, qr_errors) {
+  EXPECT_THROW(S21QR(S21Matrix(2, 3)), std::out_of_range);
+  S21QR rank_deficient{S21Matrix(3, 2)};
+  EXPECT_THROW(rank_deficient.Solve(S21Matrix(3, 1)), std::out_of_range);
+  // rank 1, but rounding leaves r_11 at about 1e-16 instead of 0
+  const double rank_one[3][2] = {{0.1, 0.3}, {0.7, 2.1}, {0.3, 0.9}};
+  S21Matrix a(3, 2);
+  for (int i = 0; i < 3; i++) {
+    a(i, 0) = rank_one[i][0];
+    a(i, 1) = rank_one[i][1];
+  }
+  EXPECT_THROW(S21QR(a).Solve(S21Matrix(3, 1)), std::out_of_range);
+  // full rank at any scale
+  a(0, 1) = 1;
+  S21QR tiny(a * 1e-200);
+  EXPECT_NO_THROW(tiny.Solve(S21Matrix(3, 1)));
+}
+
+//********** THREAD POOL **********
+
+TEST(ThreadPool, covers_range_once) {
+  S21ThreadPool pool(4);
+  EXPECT_EQ(pool.GetThreads(), 4);
+  std::vector<std::atomic<int>> hits(1000);
+  pool.ParallelFor(1000, 7, [&](int begin, int end) {
+    EXPECT_GE(end - begin, 1);
+    for (int i = begin; i < end; i++) hits[i]++;
+  });
+  for (const std::atomic<int>& hit : hits) EXPECT_EQ(hit, 1);
+}
+
+TEST(ThreadPool, nested_and_exceptions) {
+  S21ThreadPool pool(3);
+  std::atomic<int> total{0};
+  pool.ParallelFor(10, 1, [&](int begin, int end) {
+    pool.ParallelFor(end - begin, 1, [&](int b, int e) { total += e - b; });
+  });
+  EXPECT_EQ(total, 10);
+  EXPECT_THROW(pool.ParallelFor(100, 1,
+                                [](int begin, int) {
+                                  if (begin >= 50) {
+                                    throw std::out_of_range("chunk");
+                                  }
+                                }),
+               std::out_of_range);
+  pool.Resize(1);
+  EXPECT_EQ(pool.GetThreads(), 1);
+}
+
+TEST(ThreadPool, parallel_matches_serial) {
+  const int n = 300;
+  S21Matrix a(n, n + 7), b(n + 7, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n + 7; j++) {
+      a(i, j) = (i * 13 + j * 7) % 19 - 9.0;
+      b(j, i) = (i * 5 + j * 11) % 17 * 0.5;
+    }
+    a(i, i) += 100;
+  }
+  S21ThreadPool::Global().Resize(1);
+  S21Matrix product = a * b, sum = a + a, scaled = a * 3.0;
+  S21Matrix transposed = a.Transpose(), square = a;
+  square.SetCols(n);
+  S21Matrix inverse = square.InverseMatrix();
+  S21ThreadPool::Global().Resize(4);
+  EXPECT_TRUE(a * b == product);
+  EXPECT_TRUE(a + a == sum);
+  EXPECT_TRUE(a * 3.0 == scaled);
+  EXPECT_TRUE(a.Transpose() == transposed);
+  EXPECT_TRUE(square.InverseMatrix() == inverse);
+  S21ThreadPool::Global().Resize(0);
+}
+
+TEST(TaskGraph, runs_after_dependencies) {
+  S21ThreadPool pool(4);
+  S21TaskGraph graph;
+  const int count = 500;
+  std::vector<std::vector<int>> after(count);
+  std::vector<int> finished(count, -1);
+  std::atomic<int> clock{0};
+  unsigned seed = 7;
+  for (int i = 0; i < count; i++) {
+    for (int d = 0; d < 3 && i > 0; d++) {
+      seed = seed * 1664525u + 1013904223u;
+      after[i].push_back(static_cast<int>(seed % i));
+    }
+    after[i].push_back(-1);
+    EXPECT_EQ(graph.Add([&, i] { finished[i] = clock++; }, after[i]), i);
+  }
+  EXPECT_EQ(graph.GetTasks(), count);
+  graph.Run(pool);
+  EXPECT_EQ(graph.GetTasks(), 0);
+  for (int i = 0; i < count; i++) {
+    for (int before : after[i]) {
+      if (before >= 0) {
+        EXPECT_LT(finished[before], finished[i]);
+      }
+    }
+  }
+}
+
+TEST(TaskGraph, exceptions_skip_the_rest) {
+  S21ThreadPool pool(3);
+  S21TaskGraph graph;
+  std::atomic<int> runs{0};
+  const int failing =
+      graph.Add([] { throw std::out_of_range("task"); }, {});
+  for (int i = 0; i < 10; i++) graph.Add([&] { runs++; }, {failing});
+  EXPECT_THROW(graph.Run(pool), std::out_of_range);
+  EXPECT_EQ(runs, 0);
+  EXPECT_NO_THROW(graph.Run(pool));
+}
+
+TEST(TaskGraph, tiled_factorizations_match) {
+  const int n = 300;
+  S21Matrix a = Uniform(n, n, 9);
+  S21Matrix blocked = a, tiled = a;
+  std::vector<int> blocked_perm(n), tiled_perm(n);
+  S21ThreadPool::Global().Resize(4);
+  const int sign = s21::LuFactorBlocked(blocked.data(), n, blocked.stride(),
+                                        blocked_perm.data());
+  EXPECT_EQ(s21::LuFactorTiled(tiled.data(), n, tiled.stride(),
+                               tiled_perm.data()),
+            sign);
+  EXPECT_EQ(tiled_perm, blocked_perm);
+  EXPECT_TRUE(tiled == blocked);
+  const S21Matrix spd = SpdMatrix(n), b = RightSide(n, 2);
+  S21Cholesky parallel(spd);
+  EXPECT_TRUE(spd * parallel.Solve(b) == b);
+  S21ThreadPool::Global().Resize(1);
+  EXPECT_TRUE(S21Cholesky(spd).Solve(b) == parallel.Solve(b));
+  S21ThreadPool::Global().Resize(0);
+}
+
+//********** TEMPORARIES **********
+
+static int AllocationsOf(const std::function<void()>& expression) {
+  const int before = aligned_allocations;
+  expression();
+  return aligned_allocations - before;
+}
+
+TEST(Temporaries, move_assignment) {
+  S21Matrix a(3, 3), b(2, 2);
+  a(1, 1) = 5;
+  EXPECT_EQ(AllocationsOf([&] { b = std::move(a); }), 0);
+  EXPECT_EQ(b.GetRows(), 3);
+  EXPECT_DOUBLE_EQ(b(1, 1), 5);
+  EXPECT_EQ(a.GetRows(), 0);
+  EXPECT_EQ(a.data(), nullptr);
+}
+
+TEST(Temporaries, one_buffer_per_expression) {
+  S21Matrix a(4, 4), b(4, 4), c(4, 4), r(4, 4);
+  for (int i = 0; i < 4; i++) {
+    a(i, i) = 1;
+    b(i, 0) = i;
+    c(0, i) = 2;
+  }
+  S21Matrix expected = a;
+  expected += b;
+  expected += c;
+  expected -= a;
+  expected *= 2.0;
+  EXPECT_EQ(AllocationsOf([&] { r = (a + b + c - a) * 2.0; }), 1);
+  EXPECT_TRUE(r == expected);
+  EXPECT_EQ(AllocationsOf([&] { r = 2.0 * (a + (b + c)); }), 1);
+  EXPECT_EQ(AllocationsOf([&] { r = a * b; }), 1);
+  EXPECT_EQ(AllocationsOf([&] { r.MulMatrix(c); }), 1);
+  EXPECT_EQ(AllocationsOf([&] { r = a; }), 0);
+  EXPECT_EQ(AllocationsOf([&] { r.SetRows(5); }), 1);
+}
+
+//********** EXPRESSIONS **********
+
+static S21Matrix Numbered(int rows, int cols, int seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) m(i, j) = (i * 7 + j * 3 + seed) % 11 - 5;
+  }
+  return m;
+}
+
+TEST(Expressions, fused_matches_eager) {
+  S21Matrix a = Numbered(5, 4, 1), b = Numbered(5, 4, 2);
+  S21Matrix c = Numbered(5, 4, 3);
+  S21Matrix expected = a + b * 2.0 - c;
+  S21Matrix fused(s21::Lazy(a) + s21::Lazy(b) * 2.0 - c);
+  EXPECT_TRUE(fused == expected);
+  S21Matrix r(5, 4);
+  const double* buffer = r.data();
+  EXPECT_EQ(AllocationsOf([&] { r = s21::Lazy(a) + s21::Lazy(b) * 2.0 - c; }),
+            0);
+  EXPECT_EQ(r.data(), buffer);
+  EXPECT_TRUE(r == expected);
+  EXPECT_TRUE(S21Matrix(-s21::Lazy(a)) == a * -1.0);
+}
+
+TEST(Expressions, transpose_and_products) {
+  S21Matrix a = Numbered(3, 4, 1), b = Numbered(4, 3, 2);
+  S21Matrix t = (s21::Lazy(a).Transpose() + b).Eval();
+  EXPECT_TRUE(t == a.Transpose() + b);
+  EXPECT_TRUE(S21Matrix(s21::Lazy(a) * b) == a * b);
+  EXPECT_TRUE(S21Matrix(s21::Lazy(b).Transpose() * a.Transpose()) ==
+              b.Transpose() * a.Transpose());
+  EXPECT_TRUE(S21Matrix(s21::Lazy(a) * b * 0.5 + a * b) == a * b * 1.5);
+  EXPECT_TRUE(S21Matrix((s21::Lazy(a) + a) * b) == (a + a) * b);
+}
+
+TEST(Expressions, aliasing_and_errors) {
+  S21Matrix a = Numbered(3, 3, 1), b = Numbered(3, 3, 2);
+  S21Matrix expected = a.Transpose() + b;
+  a = s21::Lazy(a).Transpose() + b;
+  EXPECT_TRUE(a == expected);
+  S21Matrix c = Numbered(3, 3, 1);
+  expected = c + c;
+  c = s21::Lazy(c) + c;
+  EXPECT_TRUE(c == expected);
+  EXPECT_THROW(s21::Lazy(a) + Numbered(2, 3, 0), std::out_of_range);
+  EXPECT_THROW(s21::Lazy(a) * Numbered(2, 3, 0), std::out_of_range);
+}
+
+//********** FIXED-SIZE **********
+
+template <int N>
+static void ExpectFixedMatchesDynamic() {
+  S21Matrix dynamic = Numbered(N, N, N);
+  for (int i = 0; i < N; i++) dynamic(i, i) += 10;
+  S21FixedMatrix<N, N> fixed(dynamic);
+  EXPECT_NEAR(fixed.Determinant(), dynamic.Determinant(),
+              1e-9 * std::fabs(dynamic.Determinant()));
+  EXPECT_TRUE(static_cast<S21Matrix>(fixed.InverseMatrix()) ==
+              dynamic.InverseMatrix());
+  EXPECT_TRUE(static_cast<S21Matrix>(fixed.CalcComplements()) ==
+              dynamic.CalcComplements());
+  EXPECT_TRUE(static_cast<S21Matrix>(fixed * fixed.Transpose()) ==
+              dynamic * dynamic.Transpose());
+}
+
+TEST(FixedMatrix, matches_dynamic) {
+  ExpectFixedMatchesDynamic<1>();
+  ExpectFixedMatchesDynamic<2>();
+  ExpectFixedMatchesDynamic<3>();
+  ExpectFixedMatchesDynamic<4>();
+  ExpectFixedMatchesDynamic<6>();
+}
+
+TEST(FixedMatrix, arithmetic_and_conversions) {
+  constexpr S21Matrix2 a({1, 2, 3, 4});
+  static_assert(a.Determinant() == -2, "closed-form determinant");
+  static_assert(S21FixedMatrix<2, 3>::GetCols() == 3, "constexpr dimensions");
+  S21FixedMatrix<2, 3> b({1, 0, 2, -1, 3, 1});
+  S21FixedMatrix<2, 3> c = a * b;
+  EXPECT_DOUBLE_EQ(c(0, 0), -1);
+  EXPECT_DOUBLE_EQ(c(1, 2), 10);
+  EXPECT_TRUE(2.0 * b - b == b);
+  EXPECT_TRUE(a * a.InverseMatrix() == S21Matrix2::Identity());
+  EXPECT_EQ(AllocationsOf([&] { c = a * (c + b) * 0.5; }), 0);
+  EXPECT_THROW(c.At(2, 0), std::out_of_range);
+  EXPECT_THROW(S21Matrix3(S21Matrix(3, 2)), std::out_of_range);
+  EXPECT_THROW(S21Matrix3().InverseMatrix(), std::out_of_range);
+  EXPECT_THROW((S21FixedMatrix<5, 5>().InverseMatrix()), std::out_of_range);
+  EXPECT_TRUE(S21Matrix2(static_cast<S21Matrix>(a)) == a);
+}
+
+//********** MEMORY RESOURCES **********
+
+TEST(Memory, pool_reuses_buffers) {
+  S21Matrix a = Numbered(20, 30, 1), b = Numbered(20, 30, 2);
+  S21MatrixResourceScope scope(&S21MatrixPool::Instance());
+  S21Matrix r;
+  auto step = [&] { r = a + b * 2.0 - a * a.Transpose() * b; };
+  step();
+  step();
+  EXPECT_EQ(r.GetResource(), &S21MatrixPool::Instance());
+  const std::size_t upstream =
+      S21MatrixPool::Instance().GetUpstreamAllocations();
+  EXPECT_EQ(AllocationsOf([&] {
+              for (int i = 0; i < 10; i++) step();
+            }),
+            0);
+  EXPECT_EQ(S21MatrixPool::Instance().GetUpstreamAllocations(), upstream);
+  EXPECT_TRUE(r == a + b * 2.0 - a * a.Transpose() * b);
+  r.SetCols(40);
+  EXPECT_EQ(r.GetResource(), &S21MatrixPool::Instance());
+  S21MatrixPool::Instance().Trim();
+}
+
+TEST(Memory, arena_scope) {
+  S21Matrix a = Numbered(6, 6, 1) + Numbered(6, 6, 10).Transpose();
+  S21Matrix result(6, 6);
+  EXPECT_EQ(result.GetResource(), s21::AlignedNewResource());
+  {
+    S21ScopedArena arena;
+    EXPECT_EQ(s21::CurrentMatrixResource(), arena.GetResource());
+    S21Matrix t = a * a;
+    EXPECT_EQ(t.GetResource(), arena.GetResource());
+    {
+      S21MatrixResourceScope nested(s21::AlignedNewResource());
+      EXPECT_EQ(S21Matrix(1, 1).GetResource(), s21::AlignedNewResource());
+    }
+    result = t + a.InverseMatrix();
+    arena.Reset();
+  }
+  EXPECT_EQ(s21::CurrentMatrixResource(), s21::AlignedNewResource());
+  EXPECT_EQ(result.GetResource(), s21::AlignedNewResource());
+  EXPECT_TRUE(result == a * a + a.InverseMatrix());
+}
+
+TEST(Memory, explicit_resource) {
+  std::pmr::monotonic_buffer_resource arena;
+  S21Matrix a(3, 3, &arena);
+  EXPECT_EQ(a.GetResource(), &arena);
+  a(1, 1) = 2;
+  S21Matrix copy(a);
+  EXPECT_EQ(copy.GetResource(), s21::AlignedNewResource());
+  S21Matrix moved(std::move(a));
+  EXPECT_EQ(moved.GetResource(), &arena);
+  copy = std::move(moved);
+  EXPECT_EQ(copy.GetResource(), s21::AlignedNewResource());
+  EXPECT_DOUBLE_EQ(copy(1, 1), 2);
+}
+
+//********** VIEWS **********
+
+TEST(Views, slices_share_storage) {
+  S21Matrix a = Numbered(4, 5, 1);
+  S21MatrixView block = S21MatrixView(a).Block(1, 2, 3, 2);
+  EXPECT_EQ(block.GetRows(), 3);
+  EXPECT_DOUBLE_EQ(block(0, 1), a(1, 3));
+  block(2, 0) = 42;
+  EXPECT_DOUBLE_EQ(a(3, 2), 42);
+  S21ConstMatrixView t = S21ConstMatrixView(a).TransposedView();
+  EXPECT_TRUE(t == a.Transpose());
+  EXPECT_TRUE(t.Row(2) == S21ConstMatrixView(a).Col(2).TransposedView());
+  EXPECT_TRUE(S21MatrixView(a).TransposedView().Row(3).TransposedView() ==
+              S21MatrixView(a).Col(3).ToMatrix());
+  EXPECT_THROW(block.Block(1, 0, 3, 1), std::out_of_range);
+  EXPECT_THROW(block(3, 0), std::out_of_range);
+  EXPECT_THROW(block.SumMatrix(a), std::out_of_range);
+  // a mutable view detaches a shared buffer, which allocates
+  EXPECT_FALSE(
+      (std::is_nothrow_constructible<S21MatrixView, S21Matrix&>::value));
+  EXPECT_TRUE((std::is_nothrow_constructible<S21ConstMatrixView,
+                                             const S21Matrix&>::value));
+}
+
+TEST(Views, arithmetic_matches_copies) {
+  S21Matrix a = Numbered(6, 6, 1), b = Numbered(6, 6, 2);
+  S21ConstMatrixView top = S21ConstMatrixView(a).Block(0, 0, 3, 6);
+  S21ConstMatrixView right = S21ConstMatrixView(b).Block(0, 2, 6, 4);
+  EXPECT_TRUE(top * right == top.ToMatrix() * right.ToMatrix());
+  EXPECT_TRUE(top.TransposedView() * top ==
+              top.ToMatrix().Transpose() * top.ToMatrix());
+  EXPECT_TRUE(top * 2.0 == top + top);
+
+  S21Matrix expected = a;
+  S21Matrix b_block = S21ConstMatrixView(b).Block(3, 0, 3, 3).ToMatrix();
+  S21Matrix sum = S21ConstMatrixView(a).Block(0, 3, 3, 3) + b_block;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) expected(i, 3 + j) = sum(i, j);
+  }
+  S21MatrixView(a).Block(0, 3, 3, 3) += S21ConstMatrixView(b).Block(3, 0, 3, 3);
+  EXPECT_TRUE(a == expected);
+}
+
+TEST(Views, block_update_and_aliasing) {
+  // trailing update of a block algorithm: A22 -= A21 * A12 in place
+  S21Matrix a = Numbered(8, 8, 3);
+  S21Matrix expected = a;
+  S21MatrixView whole(a);
+  S21Matrix update = whole.Block(4, 0, 4, 4) * whole.Block(0, 4, 4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) expected(4 + i, 4 + j) -= update(i, j);
+  }
+  EXPECT_EQ(AllocationsOf([&] {
+              whole.Block(4, 4, 4, 4).MulAdd(whole.Block(4, 0, 4, 4),
+                                             whole.Block(0, 4, 4, 4), -1.0);
+            }),
+            0);
+  EXPECT_TRUE(a == expected);
+
+  // in-place transpose through a view goes via a temporary
+  S21Matrix b = Numbered(5, 5, 4);
+  S21Matrix transposed = b.Transpose();
+  S21MatrixView(b).Assign(S21MatrixView(b).TransposedView());
+  EXPECT_TRUE(b == transposed);
+
+  // product into a transposed destination that overlaps an operand
+  S21Matrix c = Numbered(4, 4, 5);
+  S21Matrix product = (c * c).Transpose();
+  S21Matrix zero(4, 4);
+  S21MatrixView(c).TransposedView().Assign(zero);
+  S21Matrix d = Numbered(4, 4, 5);
+  S21MatrixView(c).TransposedView().MulAdd(d, d);
+  EXPECT_TRUE(c == product);
+  S21MatrixView(d).TransposedView().MulAdd(d, S21Matrix(4, 4));
+  EXPECT_TRUE(d == Numbered(4, 4, 5));
+}
+
+//********** TRANSPOSE **********
+
+// every element distinct, so a misplaced one cannot go unnoticed
+static S21Matrix Distinct(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) m(i, j) = i * 1000 + j;
+  }
+  return m;
+}
+
+TEST(Transpose, shapes_match_reference) {
+  for (int rows : {1, 7, 33, 100, 257}) {
+    for (int cols : {1, 8, 45, 130}) {
+      S21Matrix a = Distinct(rows, cols), expected(cols, rows);
+      for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) expected(j, i) = a(i, j);
+      }
+      EXPECT_TRUE(a.Transpose() == expected);
+      a.TransposeInPlace();
+      EXPECT_EQ(a.GetRows(), cols);
+      EXPECT_EQ(a.stride(), rows);
+      EXPECT_TRUE(a == expected) << rows << "x" << cols;
+    }
+  }
+}
+
+TEST(Transpose, in_place_square) {
+  for (int n : {1, 2, 31, 32, 33, 100, 300}) {
+    S21Matrix a = Distinct(n, n), expected = a.Transpose();
+    const double* buffer = a.data();
+    EXPECT_EQ(AllocationsOf([&] { a.TransposeInPlace(); }), 0);
+    EXPECT_EQ(a.data(), buffer);
+    EXPECT_TRUE(a == expected) << n;
+  }
+}
+
+//********** PERSISTENCE **********
+
+TEST(Persistence, save_load_and_map) {
+  const std::string path = testing::TempDir() + "s21_matrix_io_test.bin";
+  S21Matrix a = Distinct(37, 53);
+  a.Save(path);
+  EXPECT_TRUE(S21Matrix::Load(path) == a);
+  const S21MappedMatrix mapped = S21MappedMatrix::MapFromFile(path);
+  EXPECT_EQ(mapped.GetRows(), 37);
+  EXPECT_EQ(mapped.GetCols(), 53);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped.data()) % 64, 0u);
+  EXPECT_EQ(mapped(36, 52), a(36, 52));
+  EXPECT_THROW(mapped(37, 0), std::out_of_range);
+  EXPECT_TRUE(mapped.Verify());
+  EXPECT_TRUE(mapped.View() == a);
+  EXPECT_TRUE(mapped.View().TransposedView() == a.Transpose());
+  // saving over a mapped file leaves the mapping intact
+  S21Matrix b(2, 2);
+  b.Save(path);
+  EXPECT_TRUE(mapped.ToMatrix() == a);
+  EXPECT_TRUE(S21Matrix::Load(path) == b);
+  std::remove(path.c_str());
+}
+
+TEST(Persistence, rejects_bad_files) {
+  const std::string path = testing::TempDir() + "s21_matrix_io_bad.bin";
+  EXPECT_THROW(S21Matrix().Save(path), std::out_of_range);
+  EXPECT_THROW(S21MappedMatrix::MapFromFile(path), std::runtime_error);
+  S21Matrix a = Distinct(10, 10);
+  a.Save(path);
+  {
+    // flip one element
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(64 + 8 * 42);
+    file.put('x');
+  }
+  EXPECT_FALSE(S21MappedMatrix::MapFromFile(path).Verify());
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+  {
+    // header promises more data than there is
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    s21::MatrixFileHeader header = s21::MakeMatrixFileHeader(10, 10, 0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(a.data()), 8 * 99);
+  }
+  EXPECT_THROW(S21MappedMatrix::MapFromFile(path), std::runtime_error);
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << std::string(128, 'x');
+  }
+  EXPECT_THROW(S21Matrix::Load(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(Persistence, streaming_reader_and_writer) {
+  const std::string path = testing::TempDir() + "s21_matrix_stream.bin";
+  std::remove(path.c_str());
+  const S21Matrix a = Distinct(23, 17);
+  {
+    // blocks out of order; nothing appears before Close()
+    S21MatrixWriter writer(path, 23, 17);
+    writer.WriteBlock(10, 5, S21ConstMatrixView(a).Block(10, 5, 13, 12));
+    writer.WriteBlock(0, 0, S21ConstMatrixView(a).Block(0, 0, 23, 5));
+    writer.WriteBlock(0, 5, S21ConstMatrixView(a).Block(0, 5, 10, 12));
+    EXPECT_THROW(S21MatrixReader{path}, std::runtime_error);
+    writer.Close();
+  }
+  EXPECT_TRUE(S21Matrix::Load(path) == a);
+  S21MatrixReader reader(path);
+  EXPECT_TRUE(reader.Verify());
+  S21Matrix chunk(10, 17), block(4, 3);
+  EXPECT_EQ(reader.ReadRows(chunk), 10);
+  EXPECT_EQ(reader.ReadRows(chunk), 10);
+  EXPECT_TRUE(S21ConstMatrixView(a).Block(10, 0, 10, 17) == chunk);
+  EXPECT_EQ(reader.ReadRows(chunk), 3);
+  EXPECT_EQ(reader.ReadRows(chunk), 0);
+  reader.ReadBlock(20, 13, S21MatrixView(block).TransposedView());
+  EXPECT_TRUE(S21ConstMatrixView(a).Block(20, 13, 3, 4) == block.Transpose());
+  EXPECT_THROW(reader.ReadBlock(20, 13, block), std::out_of_range);
+  {
+    // abandoned writers leave the old file alone
+    S21MatrixWriter writer(path, 2, 2);
+    writer.WriteRows(S21ConstMatrixView(a).Block(0, 0, 2, 2));
+  }
+  EXPECT_TRUE(S21Matrix::Load(path) == a);
+  {
+    // each writer has a temporary of its own; the last to close wins
+    const S21Matrix b = a * 2;
+    S21MatrixWriter first(path, 23, 17), second(path, 23, 17);
+    first.WriteRows(a);
+    second.WriteRows(b);
+    first.Close();
+    EXPECT_TRUE(S21Matrix::Load(path) == a);
+    second.Close();
+    EXPECT_TRUE(S21Matrix::Load(path) == b);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(Persistence, out_of_core_operations) {
+  const std::string dir = testing::TempDir();
+  const std::string a_path = dir + "s21_ooc_a.bin";
+  const std::string b_path = dir + "s21_ooc_b.bin";
+  const std::string c_path = dir + "s21_ooc_c.bin";
+  S21Matrix a = Distinct(37, 29), b = Distinct(29, 41) * 0.001;
+  a.Save(a_path);
+  b.Save(b_path);
+  // budgets far below the operand sizes force many tiles and edge tiles
+  for (std::size_t budget : {512, 4096, 1 << 20}) {
+    s21::OutOfCoreMulMatrix(a_path, b_path, c_path, budget);
+    EXPECT_TRUE(S21Matrix::Load(c_path) == a * b) << budget;
+    s21::OutOfCoreTranspose(a_path, c_path, budget);
+    EXPECT_TRUE(S21Matrix::Load(c_path) == a.Transpose()) << budget;
+    s21::OutOfCoreSumMatrix(a_path, a_path, c_path, budget);
+    EXPECT_TRUE(S21Matrix::Load(c_path) == a * 2) << budget;
+  }
+  EXPECT_THROW(s21::OutOfCoreMulMatrix(b_path, b_path, c_path),
+               std::out_of_range);
+  EXPECT_THROW(s21::OutOfCoreSumMatrix(a_path, b_path, c_path),
+               std::out_of_range);
+  for (const std::string& path : {a_path, b_path, c_path}) {
+    std::remove(path.c_str());
+  }
+}
+
+//********** SPARSE **********
+
+// about one element in seven non-zero, in a pattern with empty rows and
+// columns
+static S21Matrix SparseValues(int rows, int cols, int seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      if ((i * 31 + j * 17 + seed) % 7 == 0 && i % 5 != 3) {
+        m(i, j) = (i + 1) * 0.5 - j * 0.25 + seed;
+      }
+    }
+  }
+  return m;
+}
+
+TEST(Sparse, conversions) {
+  using Format = S21SparseMatrix::Format;
+  S21Matrix dense = SparseValues(13, 9, 1);
+  dense(0, 0) = 1e-9;
+  for (Format format : {Format::kCsr, Format::kCsc}) {
+    const S21SparseMatrix sparse(dense, format);
+    EXPECT_TRUE(sparse.ToDense() == dense);
+    EXPECT_EQ(sparse(0, 0), 1e-9);
+    EXPECT_EQ(S21SparseMatrix(dense, format, 1e-6)(0, 0), 0.0);
+    EXPECT_EQ(sparse(12, 8), dense(12, 8));
+    EXPECT_THROW(sparse(13, 0), std::out_of_range);
+    const S21SparseMatrix other = sparse.ToFormat(
+        format == Format::kCsr ? Format::kCsc : Format::kCsr);
+    EXPECT_NE(other.GetFormat(), format);
+    EXPECT_EQ(other.GetNonZeros(), sparse.GetNonZeros());
+    EXPECT_TRUE(other.ToDense() == dense);
+    EXPECT_TRUE(other == sparse);
+    EXPECT_TRUE(sparse.Transpose().ToDense() == dense.Transpose());
+  }
+  const S21SparseMatrix triplets = S21SparseMatrix::FromTriplets(
+      3, 4, {{2, 3, 1.0}, {0, 1, 2.0}, {2, 3, 0.5}, {2, 0, -1.0}},
+      Format::kCsc);
+  EXPECT_EQ(triplets.GetNonZeros(), 3u);
+  EXPECT_EQ(triplets(2, 3), 1.5);
+  EXPECT_EQ(triplets(0, 1), 2.0);
+  EXPECT_EQ(triplets(1, 1), 0.0);
+  EXPECT_THROW(S21SparseMatrix::FromTriplets(3, 4, {{3, 0, 1.0}}),
+               std::out_of_range);
+  EXPECT_THROW(S21SparseMatrix(0, 4), std::out_of_range);
+}
+
+TEST(Sparse, arithmetic_matches_dense) {
+  using Format = S21SparseMatrix::Format;
+  const S21Matrix a = SparseValues(40, 30, 2), b = SparseValues(30, 50, 3);
+  const S21Matrix c = SparseValues(40, 30, 4);
+  for (Format left : {Format::kCsr, Format::kCsc}) {
+    for (Format right : {Format::kCsr, Format::kCsc}) {
+      const S21SparseMatrix sa(a, left), sb(b, right), sc(c, right);
+      EXPECT_TRUE(sa * b == a * b);
+      const S21SparseMatrix product = sa * sb;
+      EXPECT_EQ(product.GetFormat(), left);
+      EXPECT_TRUE(product.ToDense() == a * b);
+      EXPECT_TRUE((sa + sc).ToDense() == a + c);
+      EXPECT_TRUE((sa - sc).ToDense() == a - c);
+      EXPECT_TRUE((2.0 * sa).ToDense() == a * 2.0);
+    }
+  }
+  // exact cancellation leaves nothing stored
+  S21SparseMatrix sa(a);
+  sa -= S21SparseMatrix(a, Format::kCsc);
+  EXPECT_EQ(sa.GetNonZeros(), 0u);
+  EXPECT_THROW(S21SparseMatrix(a) * S21SparseMatrix(a), std::out_of_range);
+  EXPECT_THROW(S21SparseMatrix(a) * a, std::out_of_range);
+  EXPECT_THROW(S21SparseMatrix(a) + S21SparseMatrix(b), std::out_of_range);
+}
+
+//********** BATCH **********
+
+// well conditioned, with pivoting needed in the first column
+static S21Matrix BatchValues(int rows, int cols, int seed) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      m(i, j) = ((i * 7 + j * 3 + seed) % 11) * 0.25 - 1;
+    }
+    if (i < cols) m(i, i) += rows;
+  }
+  m(0, 0) = 0.5;
+  return m;
+}
+
+static S21MatrixBatch BatchOf(int count, int rows, int cols, int seed) {
+  S21MatrixBatch batch(count, rows, cols);
+  for (int i = 0; i < count; i++) {
+    batch.Set(i, BatchValues(rows, cols, seed + i));
+  }
+  return batch;
+}
+
+TEST(Batch, matches_single_matrices) {
+  for (int n : {1, 4, 5, 16}) {
+    const S21MatrixBatch a = BatchOf(13, n, n, 0), b = BatchOf(13, n, 3, 5);
+    const S21MatrixBatch product = a * b, inverse = a.InverseMatrix();
+    const S21MatrixBatch solution = a.Solve(b);
+    const std::vector<double> det = a.Determinant();
+    ASSERT_EQ(det.size(), 13u);
+    for (int i = 0; i < 13; i++) {
+      const S21Matrix m = a.Get(i);
+      EXPECT_TRUE(product.Get(i) == m * b.Get(i));
+      EXPECT_TRUE(inverse.Get(i) == m.InverseMatrix());
+      EXPECT_TRUE(m * solution.Get(i) == b.Get(i));
+      EXPECT_NEAR(det[i], m.Determinant(), 1e-9 * std::fabs(det[i]));
+    }
+  }
+}
+
+TEST(Batch, elements_and_errors) {
+  S21MatrixBatch a(9, 3, 3);
+  EXPECT_EQ(a.GetCount(), 9);
+  EXPECT_EQ(a.GetRows(), 3);
+  EXPECT_EQ(a.GetCols(), 3);
+  a(8, 2, 1) = 4;
+  EXPECT_EQ(a.Get(8)(2, 1), 4);
+  EXPECT_EQ(a.data()[(3 * 3 + 2 * 3 + 1) * S21MatrixBatch::kLanes], 4);
+  // every matrix but one is singular
+  EXPECT_EQ(a.Determinant()[8], 0);
+  for (int i = 0; i < 9; i++) a.Set(i, BatchValues(3, 3, i));
+  a.Set(5, S21Matrix(3, 3));
+  EXPECT_EQ(a.Determinant()[5], 0);
+  EXPECT_THROW(a.InverseMatrix(), std::out_of_range);
+  EXPECT_THROW(a.Solve(a), std::out_of_range);
+  EXPECT_THROW(a(9, 0, 0), std::out_of_range);
+  EXPECT_THROW(a(0, 3, 0), std::out_of_range);
+  EXPECT_THROW(a.Set(0, S21Matrix(3, 2)), std::out_of_range);
+  EXPECT_THROW(a * S21MatrixBatch(8, 3, 3), std::out_of_range);
+  EXPECT_THROW(a * S21MatrixBatch(9, 2, 3), std::out_of_range);
+  EXPECT_THROW(S21MatrixBatch(9, 3, 2).Determinant(), std::out_of_range);
+  EXPECT_THROW(S21MatrixBatch(0, 3, 3), std::out_of_range);
+  a *= BatchOf(9, 3, 2, 1);
+  EXPECT_EQ(a.GetCols(), 2);
+}
+
+TEST(Batch, singular_like_single_matrices) {
+  // unit pivots, but kappa_1 is about 1e34
+  S21Matrix ill(2, 2);
+  ill(0, 0) = 1, ill(0, 1) = 1e17, ill(1, 1) = 1;
+  EXPECT_THROW(ill.InverseMatrix(), std::out_of_range);
+  EXPECT_TRUE(S21LU(ill).IsSingular());
+  S21MatrixBatch a = BatchOf(10, 2, 2, 4);
+  EXPECT_NO_THROW(a.InverseMatrix());
+  EXPECT_NO_THROW(a.Solve(a));
+  a.Set(9, ill);
+  EXPECT_THROW(a.InverseMatrix(), std::out_of_range);
+  EXPECT_THROW(a.Solve(a), std::out_of_range);
+  // well conditioned at any scale
+  a.Set(9, BatchValues(2, 2, 4) * 1e-200);
+  EXPECT_NO_THROW(a.InverseMatrix());
+  EXPECT_NO_THROW(a.Solve(a));
+}
+
+TEST(Batch, large_batches_run_in_parallel) {
+  const S21MatrixBatch a = BatchOf(1001, 6, 6, 2);
+  const S21MatrixBatch product = a * a.InverseMatrix();
+  S21Matrix identity(6, 6);
+  for (int i = 0; i < 6; i++) identity(i, i) = 1;
+  for (int i = 0; i < 1001; i += 100) {
+    EXPECT_TRUE(product.Get(i) == identity);
+  }
+  EXPECT_TRUE(product.Get(1000) == identity);
+}
+
+//********** ELEMENT TYPES **********
+
+TEST(element_types, bfloat16_rounding) {
+  EXPECT_EQ(static_cast<float>(s21::BFloat16(1.0f)), 1.0f);
+  EXPECT_EQ(static_cast<float>(s21::BFloat16(-2.5f)), -2.5f);
+  // 1 + 2^-8 is halfway between 1 and 1 + 2^-7 and goes to the even one
+  EXPECT_EQ(static_cast<float>(s21::BFloat16(1.00390625f)), 1.0f);
+  EXPECT_EQ(static_cast<float>(s21::BFloat16(1.01171875f)), 1.015625f);
+  EXPECT_TRUE(std::isnan(static_cast<float>(s21::BFloat16(NAN))));
+  EXPECT_TRUE(std::isinf(static_cast<float>(s21::BFloat16(INFINITY))));
+  std::vector<float> values = {NAN, -NAN, INFINITY, -INFINITY, 0.0f, -0.0f,
+                               3.4e38f, 1e-40f};
+  for (int i = 0; i < 997; i++) {
+    values.push_back(1.0f + i / 256.0f);
+    values.push_back(-(i * 1e-3f + 0.001953125f * (i % 3)));
+  }
+  std::vector<std::uint16_t> bits(values.size());
+  s21::simd::NarrowBf16(values.data(), bits.data(), values.size());
+  std::vector<float> wide(values.size());
+  s21::simd::WidenBf16(bits.data(), wide.data(), bits.size());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    const s21::BFloat16 expected(values[i]);
+    EXPECT_EQ(bits[i], expected.bits()) << values[i];
+    if (std::isnan(values[i])) {
+      EXPECT_TRUE(std::isnan(wide[i]));
+    } else {
+      EXPECT_EQ(wide[i], static_cast<float>(expected));
+    }
+  }
+}
+
+TEST(element_types, bfloat16_product_rounds_once) {
+  // k spans 16 cache blocks of k; the sum is kept in float across them
+  const int k = 4096;
+  S21BasicMatrix<s21::BFloat16> a(1, k), b(k, 1);
+  double exact = 0;
+  for (int p = 0; p < k; p++) {
+    a(0, p) = 1.0f;
+    b(p, 0) = 1.0f + (p % 4) / 64.0f;
+    exact += 1.0 + (p % 4) / 64.0;
+  }
+  // one rounding of the exact 4192; narrowing after every block of k
+  // would give 4160
+  const s21::BFloat16 expected(static_cast<float>(exact));
+  EXPECT_EQ((a * b)(0, 0).bits(), expected.bits());
+  EXPECT_EQ(static_cast<float>(expected), 4192.0f);
+}
+
+template <typename T>
+class ElementTypes : public testing::Test {
+ protected:
+  // values exactly representable in every element type
+  static S21Matrix Values(int rows, int cols, int seed) {
+    S21Matrix m(rows, cols);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        m(i, j) = ((i * 7 + j * 3 + seed) % 13 - 6) / 4.0;
+      }
+    }
+    return m;
+  }
+
+  // |a - b| <= tolerance * (1 + |b|) element-wise
+  static bool Near(const S21BasicMatrix<T>& a, const S21Matrix& b,
+                   double tolerance) {
+    S21Matrix wide(a);
+    for (int i = 0; i < b.GetRows(); i++) {
+      for (int j = 0; j < b.GetCols(); j++) {
+        const double expected = b.data()[i * b.stride() + j];
+        if (std::fabs(wide(i, j) - expected) >
+            tolerance * (1 + std::fabs(expected))) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+};
+
+using ElementTypeList = testing::Types<float, s21::BFloat16>;
+TYPED_TEST_SUITE(ElementTypes, ElementTypeList);
+
+TYPED_TEST(ElementTypes, arithmetic_matches_double) {
+  using Matrix = S21BasicMatrix<TypeParam>;
+  const double tolerance = s21::ScalarTraits<TypeParam>::kEpsilon;
+  const S21Matrix a = this->Values(67, 45, 1), b = this->Values(67, 45, 2);
+  const Matrix na(a), nb(b);
+  EXPECT_TRUE(this->Near(na + nb, a + b, 0));
+  EXPECT_TRUE(this->Near(na - nb, a - b, 0));
+  EXPECT_TRUE(this->Near(na * 0.5, a * 0.5, 0));
+  EXPECT_TRUE(this->Near(na.Transpose(), a.Transpose(), 0));
+  Matrix in_place(na);
+  in_place.TransposeInPlace();
+  EXPECT_TRUE(in_place == na.Transpose());
+  EXPECT_TRUE(na == Matrix(a));
+  EXPECT_FALSE(na == nb);
+  for (int n : {5, 70}) {
+    const S21Matrix x = this->Values(n, n + 3, 3);
+    const S21Matrix y = this->Values(n + 3, n, 4);
+    EXPECT_TRUE(this->Near(Matrix(x) * Matrix(y), x * y, tolerance * n));
+  }
+}
+
+TYPED_TEST(ElementTypes, solvers_match_double) {
+  using Matrix = S21BasicMatrix<TypeParam>;
+  const double tolerance = s21::ScalarTraits<TypeParam>::kEpsilon * 10;
+  for (int n : {1, 3, 8, 40}) {
+    S21Matrix a = this->Values(n, n, 5);
+    for (int i = 0; i < n; i++) a(i, i) += n;
+    const Matrix na(a);
+    const double det = a.Determinant();
+    EXPECT_NEAR(na.Determinant(), det, std::fabs(det) * tolerance * n);
+    EXPECT_TRUE(this->Near(na.InverseMatrix(), a.InverseMatrix(), tolerance));
+    EXPECT_TRUE(this->Near(na * na.InverseMatrix(),
+                           S21Matrix(a * a.InverseMatrix()), tolerance * n));
+  }
+  S21Matrix a(3, 3);
+  a(0, 0) = 2, a(0, 1) = 5, a(0, 2) = 7;
+  a(1, 0) = 6, a(1, 1) = 3, a(1, 2) = 4;
+  a(2, 0) = 5, a(2, 1) = -2, a(2, 2) = -3;
+  EXPECT_TRUE(
+      this->Near(Matrix(a).CalcComplements(), a.CalcComplements(), tolerance));
+  EXPECT_THROW(Matrix(3, 3).InverseMatrix(), std::out_of_range);
+}
+
+TYPED_TEST(ElementTypes, storage_and_files) {
+  using Matrix = S21BasicMatrix<TypeParam>;
+  EXPECT_EQ(sizeof(*Matrix(1, 1).data()), sizeof(TypeParam));
+  const S21Matrix a = this->Values(9, 4, 6);
+  const std::string path = ::testing::TempDir() + "s21_element_types.bin";
+  Matrix(a).Save(path);
+  EXPECT_TRUE(S21Matrix::Load(path) == a);
+  EXPECT_TRUE(Matrix::Load(path) == Matrix(a));
+  std::remove(path.c_str());
+  Matrix b(2, 3);
+  b(1, 2) = 1.5;
+  b.SetCols(4);
+  b.SetRows(3);
+  EXPECT_EQ(static_cast<double>(b(1, 2)), 1.5);
+  EXPECT_EQ(static_cast<double>(b(2, 3)), 0);
+  EXPECT_THROW(b(3, 0), std::out_of_range);
+}
+
+//********** STORAGE **********
+
+TEST(Storage, contiguous_row_major) {
+  S21Matrix a(3, 4);
+  a(1, 2) = 5;
+  a(2, 3) = 7;
+  EXPECT_EQ(a.stride(), 4);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, 0u);
+  EXPECT_DOUBLE_EQ(a.data()[1 * a.stride() + 2], 5);
+  EXPECT_DOUBLE_EQ(a.data()[2 * a.stride() + 3], 7);
+}
+
+TEST(Storage, resize_keeps_values) {
+  S21Matrix a(2, 2);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(1, 0) = 3;
+  a(1, 1) = 4;
+  a.SetCols(3);
+  a.SetRows(3);
+  EXPECT_EQ(a.stride(), 3);
+  EXPECT_DOUBLE_EQ(a(0, 1), 2);
+  EXPECT_DOUBLE_EQ(a(1, 0), 3);
+  EXPECT_DOUBLE_EQ(a(1, 1), 4);
+  EXPECT_DOUBLE_EQ(a(1, 2), 0);
+  EXPECT_DOUBLE_EQ(a(2, 2), 0);
+  a.SetRows(1);
+  EXPECT_DOUBLE_EQ(a(0, 0), 1);
+  EXPECT_DOUBLE_EQ(a(0, 1), 2);
+}
+
+TEST(Storage, self_assignment) {
+  S21Matrix a(2, 2);
+  a(1, 1) = 3;
+  S21Matrix& ref = a;
+  a = ref;
+  EXPECT_DOUBLE_EQ(a(1, 1), 3);
+}
+
+//********** COPY-ON-WRITE **********
+
+TEST(CopyOnWrite, copies_share_until_written) {
+  S21Matrix a = Numbered(30, 30, 1);
+  S21Matrix deep(a);
+  EXPECT_FALSE(a.GetCopyOnWrite());
+  EXPECT_NE(std::as_const(deep).data(), std::as_const(a).data());
+  a.SetCopyOnWrite(true);
+  S21Matrix b, c;
+  EXPECT_EQ(AllocationsOf([&] {
+              b = a;
+              S21Matrix copy(a);
+              c = std::move(copy);
+            }),
+            0);
+  EXPECT_TRUE(b.GetCopyOnWrite());
+  EXPECT_EQ(std::as_const(b).data(), std::as_const(a).data());
+  EXPECT_EQ(std::as_const(c).data(), std::as_const(a).data());
+  EXPECT_DOUBLE_EQ(std::as_const(b)(2, 3), deep(2, 3));
+  EXPECT_TRUE(b == a);
+
+  b(2, 3) = -1;
+  EXPECT_NE(std::as_const(b).data(), std::as_const(a).data());
+  EXPECT_DOUBLE_EQ(b(2, 3), -1);
+  EXPECT_TRUE(a == deep);
+  EXPECT_TRUE(c == deep);
+  // the last owner writes in place
+  const double* buffer = std::as_const(b).data();
+  b(0, 0) = 7;
+  EXPECT_EQ(std::as_const(b).data(), buffer);
+
+  c.SetCopyOnWrite(false);
+  EXPECT_FALSE(c.GetCopyOnWrite());
+  EXPECT_NE(std::as_const(c).data(), std::as_const(a).data());
+  S21Matrix d(c);
+  EXPECT_NE(std::as_const(d).data(), std::as_const(c).data());
+  EXPECT_THROW(S21Matrix().SetCopyOnWrite(true), std::out_of_range);
+}
+
+TEST(CopyOnWrite, every_mutator_detaches) {
+  S21Matrix source = Numbered(8, 8, 3);
+  const S21Matrix expected(source);
+  source.SetCopyOnWrite(true);
+  const S21Matrix other = Numbered(8, 8, 5);
+  const std::vector<std::function<void(S21Matrix&)>> writes = {
+      [](S21Matrix& m) { m(1, 1) = 0; },
+      [](S21Matrix& m) { m.At(1, 1) = 0; },
+      [](S21Matrix& m) { m.UncheckedAt(1, 1) = 0; },
+      [](S21Matrix& m) { m.data()[9] = 0; },
+      [](S21Matrix& m) { std::fill(m.begin(), m.end(), 0.0); },
+      [](S21Matrix& m) { (*m.Rows().begin())[1] = 0; },
+      [&](S21Matrix& m) { m.SumMatrix(other); },
+      [&](S21Matrix& m) { m.SubMatrix(other); },
+      [&](S21Matrix& m) { m += other; },
+      [](S21Matrix& m) { m.MulNumber(2); },
+      [&](S21Matrix& m) { m.MulMatrix(other); },
+      [&](S21Matrix& m) { m.MulMatrixStrassen(other); },
+      [](S21Matrix& m) { m.TransposeInPlace(); },
+      [](S21Matrix& m) { m.SetRows(3); },
+      [](S21Matrix& m) { m.SetCols(9); },
+      [&](S21Matrix& m) { m = m + other * 2.0; },
+      [&](S21Matrix& m) { m = s21::Lazy(m) + s21::Lazy(other); },
+      [&](S21Matrix& m) { m = other; }};
+  for (std::size_t i = 0; i < writes.size(); i++) {
+    S21Matrix copy(source);
+    writes[i](copy);
+    EXPECT_TRUE(source == expected) << i;
+    EXPECT_FALSE(copy == expected) << i;
+  }
+  // decompositions factor a copy of their argument in place
+  EXPECT_EQ(S21LU(source).Rank(), S21LU(expected).Rank());
+  EXPECT_TRUE(source == expected);
+}
+
+TEST(CopyOnWrite, resources_and_threads) {
+  S21Matrix a = Numbered(16, 16, 2);
+  a.SetCopyOnWrite(true);
+  {
+    S21ScopedArena arena;
+    // a buffer of the default resource is not shared into the arena
+    S21Matrix copy(a);
+    EXPECT_EQ(copy.GetResource(), arena.GetResource());
+    EXPECT_TRUE(copy.GetCopyOnWrite());
+    EXPECT_NE(std::as_const(copy).data(), std::as_const(a).data());
+    EXPECT_TRUE(copy == a);
+  }
+  const S21Matrix expected(a.Transpose().Transpose());
+  std::vector<std::thread> threads;
+  std::atomic<int> detached{0};
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&a, &expected, &detached, t] {
+      for (int i = 0; i < 50; i++) {
+        S21Matrix copy(a);
+        S21Matrix reader(copy);
+        copy(t, i % 16) += 1;
+        if (reader == expected && !(copy == expected)) detached++;
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  EXPECT_EQ(detached, 200);
+  EXPECT_TRUE(a == expected);
+}
+
+//********** SIMD KERNELS **********
+
+class SimdKernels : public testing::TestWithParam<s21::simd::Isa> {
+ protected:
+  void SetUp() override {
+    if (!s21::simd::Supported(GetParam())) {
+      GTEST_SKIP() << "instruction set not available on this CPU";
+    }
+  }
+
+  static std::vector<double> Values(std::size_t n, int seed) {
+    std::vector<double> v(n);
+    for (std::size_t i = 0; i < n; i++) {
+      v[i] = static_cast<double>((i * 37 + seed * 11) % 101) / 7.0 - 5.0;
+    }
+    return v;
+  }
+};
+
+TEST_P(SimdKernels, match_scalar_reference) {
+  const s21::simd::Kernels& ref =
+      s21::simd::KernelsFor(s21::simd::Isa::kScalar);
+  const s21::simd::Kernels& k = s21::simd::KernelsFor(GetParam());
+  for (std::size_t n : {0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33, 1001}) {
+    for (std::size_t offset = 0; offset < 3; offset++) {
+      std::vector<double> src = Values(n + offset, 1);
+      std::vector<double> expected = Values(n + offset, 2);
+      std::vector<double> actual = expected;
+      ref.add(expected.data() + offset, src.data() + offset, n);
+      k.add(actual.data() + offset, src.data() + offset, n);
+      EXPECT_EQ(actual, expected);
+      ref.sub(expected.data() + offset, src.data() + offset, n);
+      k.sub(actual.data() + offset, src.data() + offset, n);
+      EXPECT_EQ(actual, expected);
+      ref.scale(expected.data() + offset, -1.75, n);
+      k.scale(actual.data() + offset, -1.75, n);
+      EXPECT_EQ(actual, expected);
+      ref.axpy(expected.data() + offset, src.data() + offset, 0.3, n);
+      k.axpy(actual.data() + offset, src.data() + offset, 0.3, n);
+      EXPECT_EQ(actual, expected);
+      EXPECT_TRUE(k.equal(actual.data(), expected.data(), actual.size(), 1e-9));
+      for (std::size_t i = 0; i < n; i++) {
+        std::vector<double> other = actual;
+        other[offset + i] += 1e-3;
+        EXPECT_EQ(k.equal(actual.data() + offset, other.data() + offset, n,
+                          1e-6),
+                  ref.equal(actual.data() + offset, other.data() + offset, n,
+                            1e-6));
+        EXPECT_TRUE(k.equal(actual.data() + offset, other.data() + offset, n,
+                            1e-2));
+      }
+    }
+  }
+}
+
+TEST_P(SimdKernels, transpose_matches_scalar) {
+  const s21::simd::Kernels& ref =
+      s21::simd::KernelsFor(s21::simd::Isa::kScalar);
+  const s21::simd::Kernels& k = s21::simd::KernelsFor(GetParam());
+  const std::vector<double> src = Values(40 * 41, 3);
+  for (std::size_t rows : {1, 2, 3, 4, 7, 8, 9, 16, 17, 33}) {
+    for (std::size_t cols : {1, 3, 4, 5, 8, 12, 31, 40}) {
+      std::vector<double> expected(41 * 41, 0.0), actual = expected;
+      ref.transpose(src.data() + 1, 41, expected.data(), 41, rows, cols);
+      k.transpose(src.data() + 1, 41, actual.data(), 41, rows, cols);
+      EXPECT_EQ(actual, expected) << rows << "x" << cols;
+    }
+  }
+}
+
+TEST_P(SimdKernels, float_kernels_match_scalar) {
+  const s21::simd::BasicKernels<float>& ref =
+      s21::simd::KernelsFor<float>(s21::simd::Isa::kScalar);
+  const s21::simd::BasicKernels<float>& k =
+      s21::simd::KernelsFor<float>(GetParam());
+  auto values = [](std::size_t n, int seed) {
+    const std::vector<double> v = Values(n, seed);
+    return std::vector<float>(v.begin(), v.end());
+  };
+  for (std::size_t n : {0, 1, 3, 4, 5, 8, 15, 16, 17, 31, 33, 1001}) {
+    std::vector<float> src = values(n + 1, 1);
+    std::vector<float> expected = values(n + 1, 2);
+    std::vector<float> actual = expected;
+    ref.add(expected.data() + 1, src.data() + 1, n);
+    k.add(actual.data() + 1, src.data() + 1, n);
+    EXPECT_EQ(actual, expected);
+    ref.sub(expected.data() + 1, src.data() + 1, n);
+    k.sub(actual.data() + 1, src.data() + 1, n);
+    EXPECT_EQ(actual, expected);
+    ref.scale(expected.data() + 1, -1.75f, n);
+    k.scale(actual.data() + 1, -1.75f, n);
+    EXPECT_EQ(actual, expected);
+    ref.axpy(expected.data() + 1, src.data() + 1, 0.3f, n);
+    k.axpy(actual.data() + 1, src.data() + 1, 0.3f, n);
+    EXPECT_EQ(actual, expected);
+    for (std::size_t i = 0; i < n; i++) {
+      std::vector<float> other = actual;
+      other[1 + i] += 1e-2f;
+      EXPECT_FALSE(k.equal(actual.data() + 1, other.data() + 1, n, 1e-3f));
+      EXPECT_TRUE(k.equal(actual.data() + 1, other.data() + 1, n, 1e-1f));
+    }
+  }
+  const std::vector<float> src = values(40 * 41, 3);
+  for (std::size_t rows : {1, 3, 4, 7, 8, 9, 16, 17, 33}) {
+    for (std::size_t cols : {1, 4, 5, 8, 12, 31, 40}) {
+      std::vector<float> expected(41 * 41, 0.0f), actual = expected;
+      ref.transpose(src.data() + 1, 41, expected.data(), 41, rows, cols);
+      k.transpose(src.data() + 1, 41, actual.data(), 41, rows, cols);
+      EXPECT_EQ(actual, expected) << rows << "x" << cols;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Isa, SimdKernels,
+                         testing::Values(s21::simd::Isa::kScalar,
+                                         s21::simd::Isa::kSse2,
+                                         s21::simd::Isa::kAvx2,
+                                         s21::simd::Isa::kAvx512));
+
+//********** STATS **********
+
+TEST(Stats, counts_operations) {
+  using s21::MatrixOp;
+  s21::ResetStats();
+  S21Matrix a(4, 4), b(4, 4);
+  a.SumMatrix(b);
+  S21Matrix c = a;
+  c = b;
+  a.MulMatrix(b);
+  s21::MatrixStats stats = s21::StatsSnapshot();
+  if (!s21::StatsEnabled()) {
+    for (const s21::OpCounters& op : stats.ops) EXPECT_EQ(op.calls, 0u);
+    return;
+  }
+  EXPECT_EQ(stats[MatrixOp::kSumMatrix].calls, 1u);
+  EXPECT_EQ(stats[MatrixOp::kSumMatrix].flops, 16u);
+  EXPECT_EQ(stats[MatrixOp::kConstruct].calls, 3u);
+  EXPECT_EQ(stats[MatrixOp::kMallocMatrix].calls, 4u);
+  EXPECT_EQ(stats[MatrixOp::kMallocMatrix].bytes_allocated, 4 * 128u);
+  EXPECT_EQ(stats[MatrixOp::kCopyConstruct].bytes_allocated, 128u);
+  EXPECT_EQ(stats[MatrixOp::kCopyConstruct].bytes_copied, 128u);
+  // same shape, the buffer is reused
+  EXPECT_EQ(stats[MatrixOp::kCopyAssign].bytes_allocated, 0u);
+  EXPECT_EQ(stats[MatrixOp::kCopyAssign].bytes_copied, 128u);
+  EXPECT_EQ(stats[MatrixOp::kCopyMatrix].calls, 2u);
+  EXPECT_EQ(stats[MatrixOp::kMulMatrix].flops, 128u);
+  EXPECT_EQ(stats[MatrixOp::kMoveAssign].calls, 1u);
+
+  s21::ResetStats();
+  S21Matrix singular(3, 3);
+  singular.CalcComplements();
+  stats = s21::StatsSnapshot();
+  EXPECT_EQ(stats[MatrixOp::kCalcComplements].calls, 1u);
+  EXPECT_EQ(stats[MatrixOp::kMinor].calls, 9u);
+  EXPECT_EQ(stats[MatrixOp::kMinor].bytes_copied, 9 * 32u);
+  EXPECT_EQ(stats[MatrixOp::kDeterminant].calls, 9u);
+  EXPECT_GE(stats[MatrixOp::kCalcComplements].bytes_copied, 9 * 32u);
+  EXPECT_GE(stats[MatrixOp::kCalcComplements].nanoseconds,
+            stats[MatrixOp::kMinor].nanoseconds +
+                stats[MatrixOp::kDeterminant].nanoseconds);
+}
+
+TEST(Stats, threads_add_up) {
+  s21::ResetStats();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([] {
+      S21Matrix a(2, 2);
+      for (int i = 0; i < 100; i++) S21Matrix b(a);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  const std::uint64_t expected = s21::StatsEnabled() ? 400 : 0;
+  EXPECT_EQ(s21::StatsSnapshot()[s21::MatrixOp::kCopyConstruct].calls,
+            expected);
+  s21::ResetStats();
+  EXPECT_EQ(s21::StatsSnapshot()[s21::MatrixOp::kCopyConstruct].calls, 0u);
+}
+
+TEST(Stats, json_and_prometheus) {
+  s21::MatrixStats stats;
+  stats.ops[static_cast<int>(s21::MatrixOp::kDeterminant)] = {
+      2, 18, 64, 32, 1500000000};
+  const std::string json = s21::StatsToJson(stats);
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(json.back(), '}');
+  EXPECT_NE(json.find("\"Determinant\": {\"calls\": 2, \"flops\": 18, "
+                      "\"bytes_allocated\": 64, \"bytes_copied\": 32, "
+                      "\"nanoseconds\": 1500000000}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"Minor\": {\"calls\": 0,"), std::string::npos);
+  const std::string text = s21::StatsToPrometheus(stats);
+  EXPECT_NE(text.find("# TYPE s21_matrix_calls_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_calls_total{op=\"Determinant\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_copied_bytes_total{op=\"Determinant\"} 32\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_seconds_total{op=\"Determinant\"} 1.5\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_calls_total{op=\"SumMatrix\"} 0\n"),
+            std::string::npos);
+  EXPECT_STREQ(s21::OpName(s21::MatrixOp::kCopyMatrix), "CopyMatrix");
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();